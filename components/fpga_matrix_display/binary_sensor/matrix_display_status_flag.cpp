@@ -6,6 +6,11 @@ namespace esphome::matrix_display::matrix_display_status {
 
 static const char *const TAG = "matrix_display.status_flag";
 
+void MatrixDisplayStatusFlag::setup() {
+    if (this->display_ != nullptr)
+        this->display_->request_status(MatrixPanel_FPGA_SPI::STATUS_ADDR_FLAGS);
+}
+
 void MatrixDisplayStatusFlag::update() {
     if (this->display_ == nullptr)
         return;
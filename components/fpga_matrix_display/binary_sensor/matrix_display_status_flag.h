@@ -16,14 +16,17 @@ enum class StatusFlagType : uint8_t {
 };
 
 /**
- * Polls one FPGA status flag over the status SPI at the configured
- * update_interval and publishes it. When the read fails (status bus not
+ * Publishes one FPGA status flag at the configured update_interval, from
+ * the display's status poller snapshot (or a direct status SPI read when
+ * the poller is off). When the read fails (status bus not
  * configured, FPGA in reset, no fresh frame) nothing is published, so the
  * last known state is retained.
  */
 class MatrixDisplayStatusFlag : public binary_sensor::BinarySensor,
                                 public PollingComponent {
   public:
+    void setup() override;
+
     void update() override;
 
     void dump_config() override;
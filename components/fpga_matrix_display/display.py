@@ -9,14 +9,20 @@ from esphome.const import (
     CONF_HEIGHT,
     CONF_ID,
     CONF_LAMBDA,
+    CONF_PLATFORM,
     CONF_UPDATE_INTERVAL,
     CONF_WIDTH,
 )
+from esphome.core import CORE
 
 DEPENDENCIES = ["esp32"]
 
 MATRIX_ID = "matrix_id"
 CHAIN_LENGTH = "chain_length"
+LAYOUT = "layout"
+LAYOUT_ROWS = "rows"
+LAYOUT_SERPENTINE = "serpentine"
+LAYOUT_ROTATIONS = "rotations"
 BRIGHTNESS = "brightness"
 
 SPI_CE_PIN =  "SPI_CE_pin"
@@ -35,13 +41,59 @@ SPISPEED = "spispeed"
 USE_CUSTOM_LIBRARY = "use_custom_library"
 USE_WATCHDOG = "use_watchdog"
 WATCHDOG_INTERVAL_USEC = "watchdog_interval_usec"
+SUSPEND_WATCHDOG_WHEN_OFF = "suspend_watchdog_when_off"
 WORKER_IDLE_TIMEOUT_MS = "worker_idle_timeout_ms"
+WORKER_CORE = "worker_core"
+FLUSH_BUDGET_US = "flush_budget_us"
+# Budget for displays without one once several share the main loop.
+SHARED_FLUSH_BUDGET_US = 2000
+RENDER_TASK = "render_task"
+FRAME_PACING = "frame_pacing"
+LATENCY_WINDOW = "latency_window"
+STATUS_POLL_INTERVAL = "status_poll_interval"
+SPI_CALIBRATION = "spi_calibration"
+INTEGRITY_REGISTER = "integrity_register"
+STAGING_BUFFERS = "staging_buffers"
+STAGING_BUFFER_BYTES = "staging_buffer_bytes"
+CONTENT_DIFF = "content_diff"
+PIXEL_FORMAT = "pixel_format"
+FRAMEBUFFER_LOCATION = "framebuffer_location"
+FRAMEBUFFER_LAYOUT = "framebuffer_layout"
+ASSET_CACHE_BYTES = "asset_cache_bytes"
+COLOR_CORRECTION = "color_correction"
+GAMMA = "gamma"
+RED = "red"
+GREEN = "green"
+BLUE = "blue"
+COMPRESS_RECTS = "compress_rects"
+CHUNK_WIDTH = "chunk_width"
 
 matrix_display_ns = cg.esphome_ns.namespace("matrix_display")
 MatrixDisplay = matrix_display_ns.class_(
     "MatrixDisplay", cg.PollingComponent, display.DisplayBuffer
 )
 
+ContentDiffMode = matrix_display_ns.enum("ContentDiffMode", is_class=True)
+CONTENT_DIFF_MODES = {
+    "none": ContentDiffMode.NONE,
+    "shadow": ContentDiffMode.SHADOW,
+    "hash": ContentDiffMode.HASH,
+}
+
+PixelFormat = matrix_display_ns.enum("PixelFormat", is_class=True)
+PIXEL_FORMATS = {
+    "RGB888": PixelFormat.RGB888,
+    "RGB565": PixelFormat.RGB565,
+    "RGB444": PixelFormat.RGB444,
+}
+
+BufferLocation = matrix_display_ns.enum("BufferLocation", is_class=True)
+BUFFER_LOCATIONS = {
+    "auto": BufferLocation.AUTO,
+    "internal": BufferLocation.INTERNAL,
+    "psram": BufferLocation.PSRAM,
+}
+
 clk_speed = cg.global_ns.namespace("FPGA_SPI_CFG").enum("clk_speed")
 CLOCK_SPEEDS = {
     "HZ_8M": clk_speed.HZ_8M,
@@ -54,35 +106,216 @@ CLOCK_SPEEDS = {
     "HZ_80M": clk_speed.HZ_80M,
 }
 
-CONFIG_SCHEMA = display.FULL_DISPLAY_SCHEMA.extend(
-    {
-        cv.GenerateID(): cv.declare_id(MatrixDisplay),
-        cv.Required(CONF_WIDTH): cv.positive_int,
-        cv.Required(CONF_HEIGHT): cv.positive_int,
-        cv.Optional(USE_CUSTOM_LIBRARY, default=False): cv.boolean,
-        cv.Optional(CHAIN_LENGTH, default=1): cv.positive_int,
-        cv.Optional(BRIGHTNESS, default=128): cv.int_range(min=0, max=255),
-        cv.Optional(
-            CONF_UPDATE_INTERVAL, default="16ms"
-        ): cv.positive_time_period_milliseconds,
-        cv.Optional(SPI_CE_PIN, default=15): pins.gpio_output_pin_schema,
-        cv.Optional(SPI_CLK_PIN, default=14): pins.gpio_output_pin_schema,
-        cv.Optional(SPI_MOSI_PIN, default=2): pins.gpio_output_pin_schema,
-        cv.Optional(FPGA_RESETSTATUS_PIN, default=27): pins.gpio_input_pin_schema,
-        cv.Optional(FPGA_BUSY_PIN, default=35): pins.gpio_input_pin_schema,
-        # Status readback SPI (FPGA reg_spi_responder). All three pins must be
-        # given together; omit all three to disable the feature.
-        cv.Inclusive(STATUS_SPI_SCK_PIN, "status_spi"): pins.gpio_output_pin_schema,
-        cv.Inclusive(STATUS_SPI_CS_PIN, "status_spi"): pins.gpio_output_pin_schema,
-        cv.Inclusive(STATUS_SPI_MISO_PIN, "status_spi"): pins.gpio_input_pin_schema,
-        cv.Optional(SPISPEED): cv.enum(CLOCK_SPEEDS, upper=True, space="_"),
-        cv.Optional(USE_WATCHDOG, default=True): cv.boolean,
-        cv.Optional(WATCHDOG_INTERVAL_USEC, default=1000000): cv.positive_int,
-        # Max time a display flush waits for the SPI worker to drain before
-        # giving up on the frame. Caps the wait so an unresponsive FPGA
-        # can't make update() block forever and leave the device frozen.
-        cv.Optional(WORKER_IDLE_TIMEOUT_MS, default=1500): cv.positive_int,
-    }
+
+
+def _validate_layout(config):
+    # The grid has to use up the chain, and a panel turned by a quarter only
+    # fits its cell when it is square.
+    if LAYOUT not in config:
+        return config
+    layout = config[LAYOUT]
+    rows = layout[LAYOUT_ROWS]
+    if config[CHAIN_LENGTH] % rows:
+        raise cv.Invalid(
+            f"{LAYOUT}: {CHAIN_LENGTH} must be a multiple of {LAYOUT_ROWS}"
+        )
+    rotations = layout[LAYOUT_ROTATIONS]
+    if len(rotations) > config[CHAIN_LENGTH]:
+        raise cv.Invalid(
+            f"{LAYOUT}: {LAYOUT_ROTATIONS} has more entries than {CHAIN_LENGTH}"
+        )
+    if config[CONF_WIDTH] != config[CONF_HEIGHT] and any(
+        rotation in (90, 270) for rotation in rotations
+    ):
+        raise cv.Invalid(f"{LAYOUT}: 90 and 270 rotations need square panels")
+    return config
+
+
+def _validate_framebuffer_layout(config):
+    # A tiled framebuffer is sent to the FPGA as is, so it has to hold the
+    # wire format already, in DMA-capable RAM, in chain order.
+    if config[FRAMEBUFFER_LAYOUT] != "tiled":
+        return config
+    if config[PIXEL_FORMAT] != "RGB888":
+        raise cv.Invalid(f"{FRAMEBUFFER_LAYOUT}: tiled requires RGB888")
+    if config[FRAMEBUFFER_LOCATION] == "psram":
+        raise cv.Invalid(f"{FRAMEBUFFER_LAYOUT}: tiled cannot live in PSRAM")
+    if COLOR_CORRECTION in config:
+        raise cv.Invalid(
+            f"{FRAMEBUFFER_LAYOUT}: tiled cannot be combined with {COLOR_CORRECTION}"
+        )
+    layout = config.get(LAYOUT)
+    if layout and (layout[LAYOUT_ROWS] > 1 or any(layout[LAYOUT_ROTATIONS])):
+        raise cv.Invalid(
+            f"{FRAMEBUFFER_LAYOUT}: tiled cannot be combined with a panel {LAYOUT}"
+        )
+    return config
+
+
+def _validate_content_diff(config):
+    # Render slots offer every row of each frame to the flush, so the render
+    # task only sends changed rows with a content diff; default it to hash.
+    if CONTENT_DIFF not in config:
+        mode = "hash" if config[RENDER_TASK] else "none"
+        config[CONTENT_DIFF] = cv.enum(CONTENT_DIFF_MODES, lower=True)(mode)
+    elif config[RENDER_TASK] and config[CONTENT_DIFF] == "none":
+        raise cv.Invalid(
+            f"{RENDER_TASK}: needs {CONTENT_DIFF} 'hash' or 'shadow'; with "
+            f"'none' every frame is a full upload"
+        )
+    return config
+
+
+def _validate_pixel_format(config):
+    # RGB444 packs pixel pairs into three bytes, so rows must hold whole pairs.
+    if config[PIXEL_FORMAT] == "RGB444" and config[CONF_WIDTH] % 2:
+        raise cv.Invalid(f"{PIXEL_FORMAT}: RGB444 requires an even {CONF_WIDTH}")
+    return config
+
+
+CONFIG_SCHEMA = cv.All(
+    display.FULL_DISPLAY_SCHEMA.extend(
+        {
+            cv.GenerateID(): cv.declare_id(MatrixDisplay),
+            cv.Required(CONF_WIDTH): cv.positive_int,
+            cv.Required(CONF_HEIGHT): cv.positive_int,
+            cv.Optional(USE_CUSTOM_LIBRARY, default=False): cv.boolean,
+            cv.Optional(CHAIN_LENGTH, default=1): cv.positive_int,
+            # Arrange the chained panels as a grid. The chain starts at the
+            # top-left panel and runs row by row; rotations are per panel in
+            # chain order, clockwise.
+            cv.Optional(LAYOUT): cv.Schema(
+                {
+                    cv.Optional(LAYOUT_ROWS, default=1): cv.positive_int,
+                    cv.Optional(LAYOUT_SERPENTINE, default=False): cv.boolean,
+                    cv.Optional(LAYOUT_ROTATIONS, default=[]): cv.ensure_list(
+                        cv.one_of(0, 90, 180, 270, int=True)
+                    ),
+                }
+            ),
+            cv.Optional(BRIGHTNESS, default=128): cv.int_range(min=0, max=255),
+            cv.Optional(
+                CONF_UPDATE_INTERVAL, default="16ms"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(SPI_CE_PIN, default=15): pins.gpio_output_pin_schema,
+            cv.Optional(SPI_CLK_PIN, default=14): pins.gpio_output_pin_schema,
+            cv.Optional(SPI_MOSI_PIN, default=2): pins.gpio_output_pin_schema,
+            cv.Optional(FPGA_RESETSTATUS_PIN, default=27): pins.gpio_input_pin_schema,
+            cv.Optional(FPGA_BUSY_PIN, default=35): pins.gpio_input_pin_schema,
+            # Status readback SPI (FPGA reg_spi_responder). All three pins must be
+            # given together; omit all three to disable the feature.
+            cv.Inclusive(STATUS_SPI_SCK_PIN, "status_spi"): pins.gpio_output_pin_schema,
+            cv.Inclusive(STATUS_SPI_CS_PIN, "status_spi"): pins.gpio_output_pin_schema,
+            cv.Inclusive(STATUS_SPI_MISO_PIN, "status_spi"): pins.gpio_input_pin_schema,
+            # Read every status register the sensors use in one burst on a
+            # background task at this interval; 0s reads on each sensor poll.
+            cv.Optional(
+                STATUS_POLL_INTERVAL, default="1s"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(SPISPEED): cv.enum(CLOCK_SPEEDS, upper=True, space="_"),
+            # Find the fastest reliable SPI clock at or above spispeed, verified
+            # against status readback; stored in flash and lowered at runtime
+            # after repeated link errors.
+            cv.Optional(SPI_CALIBRATION, default=False): cv.boolean,
+            # Status register where the FPGA sums the rect payload bytes it
+            # received; groups whose sum disagrees are sent again.
+            cv.Optional(INTEGRITY_REGISTER): cv.int_range(min=0, max=15),
+            cv.Optional(USE_WATCHDOG, default=True): cv.boolean,
+            cv.Optional(WATCHDOG_INTERVAL_USEC, default=1000000): cv.positive_int,
+            # Stop feeding the FPGA watchdog while the power switch is off.
+            cv.Optional(SUSPEND_WATCHDOG_WHEN_OFF, default=False): cv.boolean,
+            # Max time a display flush waits for the SPI worker to drain before
+            # giving up on the frame. Caps the wait so an unresponsive FPGA
+            # can't make update() block forever and leave the device frozen.
+            cv.Optional(WORKER_IDLE_TIMEOUT_MS, default=1500): cv.positive_int,
+            # Core the library's SPI worker task runs on; give each display
+            # its own core so their transfers overlap.
+            cv.Optional(WORKER_CORE, default=1): cv.int_range(min=0, max=1),
+            # Time budget per update()/loop() call for flushing; a frame that
+            # doesn't fit continues on the next call. 0 sends it all at once.
+            # Unset, it is 0 for a lone display and SHARED_FLUSH_BUDGET_US
+            # when several share the main loop.
+            cv.Optional(FLUSH_BUDGET_US): cv.int_range(
+                min=0, max=1000000
+            ),
+            # Run the writer on its own task into one of three framebuffers so
+            # rendering the next frame overlaps sending the current one.
+            # The lambda then runs on a task pinned to core 0, concurrently
+            # with the main loop on core 1: it may draw through `it` and read
+            # sensor states or globals (which can change mid-frame), but must
+            # not call into other components, and nothing else may draw on
+            # this display. Needs a content_diff (hash by default).
+            cv.Optional(RENDER_TASK, default=False): cv.boolean,
+            # Run frames on a whole multiple of the panel's HUB75 refresh
+            # period (read over status SPI) instead of the update_interval timer.
+            cv.Optional(FRAME_PACING, default=False): cv.boolean,
+            # Window the per-phase latency histograms cover before they are
+            # published to the latency sensors and restarted.
+            cv.Optional(
+                LATENCY_WINDOW, default="60s"
+            ): cv.positive_time_period_milliseconds,
+            # DMA staging buffers the flush rotates through; with two or more the
+            # next chunk is packed while the SPI worker sends the previous one.
+            cv.Optional(STAGING_BUFFERS, default=2): cv.int_range(min=1, max=4),
+            # Size of each staging buffer; adjacent dirty chunks are merged
+            # into one rect upload while the merged rect fits.
+            cv.Optional(STAGING_BUFFER_BYTES, default=8192): cv.int_range(
+                min=0, max=65536
+            ),
+            # Check written chunks for real change at flush time: "shadow" keeps a
+            # full copy of what the FPGA holds, "hash" keeps per-row hashes.
+            # Defaults to "hash" with render_task and "none" otherwise.
+            cv.Optional(CONTENT_DIFF): cv.enum(
+                CONTENT_DIFF_MODES, lower=True
+            ),
+            # Framebuffer storage format; reduced formats are expanded to RGB888
+            # when a chunk is packed, since the panel protocol only takes 888.
+            cv.Optional(PIXEL_FORMAT, default="RGB888"): cv.enum(
+                PIXEL_FORMATS, upper=True
+            ),
+            # Memory for the framebuffer, shadow copy and render slots. Staging
+            # buffers always stay in internal DMA-capable RAM.
+            cv.Optional(FRAMEBUFFER_LOCATION, default="auto"): cv.enum(
+                BUFFER_LOCATIONS, lower=True
+            ),
+            # "tiled" stores the framebuffer chunk by chunk in DMA-capable RAM
+            # and sends dirty chunks straight from it, with no staging copy.
+            cv.Optional(FRAMEBUFFER_LAYOUT, default="rows"): cv.one_of(
+                "rows", "tiled", lower=True
+            ),
+            # Memory for images kept pre-converted by cache_asset().
+            cv.Optional(ASSET_CACHE_BYTES, default=16384): cv.int_range(
+                min=0, max=1048576
+            ),
+            # Gamma and white balance applied through per-channel lookup
+            # tables while chunks are packed; the defaults leave colours as
+            # drawn and keep the plain copy.
+            cv.Optional(COLOR_CORRECTION): cv.Schema(
+                {
+                    cv.Optional(GAMMA, default=1.0): cv.float_range(
+                        min=0.1, max=5.0
+                    ),
+                    cv.Optional(RED, default=1.0): cv.percentage,
+                    cv.Optional(GREEN, default=1.0): cv.percentage,
+                    cv.Optional(BLUE, default=1.0): cv.percentage,
+                }
+            ),
+            # Send chunks of flat content as fill commands (one per band of
+            # same-coloured rows) when cheaper than the raw RGB888 rect.
+            cv.Optional(COMPRESS_RECTS, default=False): cv.boolean,
+            # Width of the column chunks used for dirty tracking and rect
+            # uploads; "auto" picks it at setup from the measured command
+            # cost and the framebuffer layout.
+            cv.Optional(CHUNK_WIDTH, default=16): cv.Any(
+                cv.one_of("auto", lower=True),
+                cv.one_of(4, 8, 16, 32, 64, int=True),
+            ),
+        }
+    ),
+    _validate_layout,
+    _validate_framebuffer_layout,
+    _validate_pixel_format,
+    _validate_content_diff,
 )
 
 
@@ -97,6 +330,15 @@ async def to_code(config):
     cg.add(var.set_panel_width(config[CONF_WIDTH]))
     cg.add(var.set_panel_height(config[CONF_HEIGHT]))
     cg.add(var.set_chain_length(config[CHAIN_LENGTH]))
+    if LAYOUT in config:
+        layout = config[LAYOUT]
+        cg.add(
+            var.set_layout(
+                layout[LAYOUT_ROWS],
+                layout[LAYOUT_SERPENTINE],
+                [rotation // 90 for rotation in layout[LAYOUT_ROTATIONS]],
+            )
+        )
     cg.add(var.set_initial_brightness(config[BRIGHTNESS]))
 
     SPI_CE_pin   = await cg.gpio_pin_expression(config[SPI_CE_PIN])
@@ -126,9 +368,53 @@ async def to_code(config):
             )
         )
 
+    cg.add(var.set_status_poll_interval_ms(config[STATUS_POLL_INTERVAL]))
+    cg.add(var.set_spi_calibration(config[SPI_CALIBRATION]))
+    if INTEGRITY_REGISTER in config:
+        cg.add(var.set_integrity_register(config[INTEGRITY_REGISTER]))
     cg.add(var.set_initial_watchdog(config[USE_WATCHDOG]))
     cg.add(var.set_initial_watchdog_interval_usec(config[WATCHDOG_INTERVAL_USEC]))
+    cg.add(var.set_suspend_watchdog_when_off(config[SUSPEND_WATCHDOG_WHEN_OFF]))
     cg.add(var.set_worker_idle_timeout_ms(config[WORKER_IDLE_TIMEOUT_MS]))
+    cg.add(var.set_worker_core(config[WORKER_CORE]))
+    # Displays share the main loop: an unbudgeted flush sends a whole frame,
+    # worker waits included, before the next display gets a turn. With
+    # several, those left unbudgeted take turns; an explicit 0 is kept.
+    displays = [
+        conf[CONF_ID].id
+        for conf in CORE.config.get("display", [])
+        if conf.get(CONF_PLATFORM) == "fpga_matrix_display"
+    ]
+    budget = config.get(FLUSH_BUDGET_US)
+    if budget is None:
+        budget = SHARED_FLUSH_BUDGET_US if len(displays) > 1 else 0
+    cg.add(var.set_flush_budget_us(budget))
+    # Stable across boots, for per-display flash slots.
+    cg.add(var.set_instance_index(displays.index(config[CONF_ID].id)))
+    cg.add(var.set_render_task(config[RENDER_TASK]))
+    cg.add(var.set_frame_pacing(config[FRAME_PACING]))
+    cg.add(var.set_latency_window_ms(config[LATENCY_WINDOW]))
+    cg.add(var.set_staging_buffers(config[STAGING_BUFFERS]))
+    cg.add(var.set_staging_buffer_bytes(config[STAGING_BUFFER_BYTES]))
+    cg.add(var.set_content_diff(config[CONTENT_DIFF]))
+    cg.add(var.set_pixel_format(config[PIXEL_FORMAT]))
+    cg.add(var.set_framebuffer_location(config[FRAMEBUFFER_LOCATION]))
+    cg.add(var.set_tiled_framebuffer(config[FRAMEBUFFER_LAYOUT] == "tiled"))
+    cg.add(var.set_asset_cache_bytes(config[ASSET_CACHE_BYTES]))
+    if COLOR_CORRECTION in config:
+        correction = config[COLOR_CORRECTION]
+        cg.add(
+            var.set_color_correction(
+                correction[GAMMA],
+                correction[RED],
+                correction[GREEN],
+                correction[BLUE],
+            )
+        )
+    cg.add(var.set_compress_rects(config[COMPRESS_RECTS]))
+    # 0 asks the component to pick the width once the driver is up.
+    chunk_width = config[CHUNK_WIDTH]
+    cg.add(var.set_chunk_width(0 if chunk_width == "auto" else chunk_width))
 
     if SPISPEED in config:
         cg.add(var.set_spispeed(config[SPISPEED]))
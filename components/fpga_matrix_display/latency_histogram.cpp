@@ -0,0 +1,54 @@
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+#include "latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace esphome {
+namespace matrix_display {
+
+size_t LatencyHistogram::bucket_of_(uint32_t micros) {
+    if (micros < 4)
+        return micros;
+    // Octave from the top set bit, quarter-octave from the next two bits.
+    const int octave = 31 - __builtin_clz(micros);
+    const size_t bucket = (static_cast<size_t>(octave - 1) << 2) +
+                          ((micros >> (octave - 2)) & 3);
+    return std::min(bucket, kBuckets - 1);
+}
+
+uint32_t LatencyHistogram::bucket_upper_(size_t bucket) {
+    if (bucket < 4)
+        return static_cast<uint32_t>(bucket);
+    const int shift = static_cast<int>(bucket >> 2) - 1;
+    const uint32_t lower = (4u + (bucket & 3)) << shift;
+    return lower + (1u << shift) - 1;
+}
+
+void LatencyHistogram::record(uint32_t micros) {
+    this->counts_[bucket_of_(micros)]++;
+    this->count_++;
+    this->min_ = std::min(this->min_, micros);
+    this->max_ = std::max(this->max_, micros);
+}
+
+void LatencyHistogram::clear() { *this = LatencyHistogram(); }
+
+uint32_t LatencyHistogram::percentile(float fraction) const {
+    if (this->count_ == 0)
+        return 0;
+    const uint32_t rank = std::max<uint32_t>(
+        1, static_cast<uint32_t>(std::ceil(fraction * this->count_)));
+    uint32_t seen = 0;
+    for (size_t bucket = 0; bucket < kBuckets; ++bucket) {
+        seen += this->counts_[bucket];
+        if (seen >= rank)
+            return std::min(std::max(bucket_upper_(bucket), this->min_),
+                            this->max_);
+    }
+    return this->max_;
+}
+
+} // namespace matrix_display
+} // namespace esphome
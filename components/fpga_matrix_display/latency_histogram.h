@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace matrix_display {
+
+/**
+ * Fixed-size histogram of microsecond latencies. Buckets are spaced
+ * logarithmically, four per power of two, so any percentile is resolved to
+ * within about 25% of its value from 0 us up to 16.7 s (larger samples land
+ * in the last bucket). Min and max are kept exactly.
+ */
+class LatencyHistogram {
+  public:
+    /// @brief number of buckets: 0-3 us singly, then four per octave up to
+    /// 2^24 us
+    static constexpr size_t kBuckets = 92;
+
+    /**
+     * Adds one sample.
+     *
+     * @param micros latency in microseconds
+     */
+    void record(uint32_t micros);
+
+    /// @brief drops every sample
+    void clear();
+
+    uint32_t count() const { return this->count_; }
+    uint32_t min() const { return this->count_ != 0 ? this->min_ : 0; }
+    uint32_t max() const { return this->max_; }
+
+    /**
+     * Estimates a percentile as the upper bound of the bucket holding it,
+     * clamped to the exact min and max.
+     *
+     * @param fraction percentile as a fraction (0.95 for p95)
+     * @return latency in microseconds; 0 without samples
+     */
+    uint32_t percentile(float fraction) const;
+
+  protected:
+    static size_t bucket_of_(uint32_t micros);
+    static uint32_t bucket_upper_(size_t bucket);
+
+    uint32_t counts_[kBuckets] = {};
+    uint32_t count_ = 0;
+    uint32_t min_ = UINT32_MAX;
+    uint32_t max_ = 0;
+};
+
+} // namespace matrix_display
+} // namespace esphome
@@ -2,8 +2,11 @@
 // SPDX-FileCopyrightText: 2025, 2026 Aaron White <w531t4@gmail.com>
 // SPDX-License-Identifier: GPL-3.0-only
 #include "matrix_display.h"
+#include "esphome/components/display/display_color_utils.h"
+#include "esphome/core/application.h"
 #include "esphome/core/helpers.h" // For micros()
 #include <algorithm>
+#include <cmath>
 #include <cstring>
 #include <esp_heap_caps.h>
 // Enable the following to expose logging for this library above ERROR
@@ -16,6 +19,15 @@ namespace matrix_display {
 
 static const char *const TAG = "matrix_display";
 
+/// Additive byte sum of a rect payload, as the FPGA's integrity register
+/// accumulates it.
+static uint32_t payload_sum(const uint8_t *data, size_t len) {
+    uint32_t sum = 0;
+    for (size_t i = 0; i < len; ++i)
+        sum += data[i];
+    return sum;
+}
+
 void MatrixDisplay::enter_test_state() {
     this->test_state_active_ = true;
     this->test_state_dirty_ = true;
@@ -44,10 +56,14 @@ void MatrixDisplay::periodic_callback(void *arg) {
     auto *self = static_cast<MatrixDisplay *>(arg);
     // ESP_LOGD(TAG, "interval_usec=%d has elapsed. feeding watchdog.",
     //          self->watchdog_interval_usec);
-    // Skip feeding the FPGA watchdog while it is held in reset/config
-    if (self->dma_display_ == nullptr || !self->dma_display_->fpga_ready())
+    // esp_timer_stop() does not wait for a callback already running, so
+    // skip this feed rather than race restart_panel_() swapping the driver.
+    if (xSemaphoreTake(self->panel_mutex_, 0) != pdTRUE)
         return;
-    self->dma_display_->fulfillWatchdog();
+    // Skip feeding the FPGA watchdog while it is held in reset/config
+    if (self->dma_display_ != nullptr && self->dma_display_->fpga_ready())
+        self->dma_display_->fulfillWatchdog();
+    xSemaphoreGive(self->panel_mutex_);
 }
 void MatrixDisplay::setup() {
     ESP_LOGCONFIG(TAG, "Setting up MatrixDisplay...");
@@ -60,44 +76,207 @@ void MatrixDisplay::setup() {
     // component
     this->mxconfig_.min_refresh_rate = 1000 / update_interval_;
     display::DisplayBuffer::setup();
+    this->layout_.configure(this->mxconfig_.mx_width, this->mxconfig_.mx_height,
+                            this->layout_rows_, this->mxconfig_.chain_length,
+                            this->layout_serpentine_, this->layout_turns_);
+    this->pieces_.reserve(this->mxconfig_.chain_length);
     this->cached_width_ = this->get_width_internal();
     this->cached_height_ = this->get_height_internal();
-    // Split the panel into fixed-width chunks for dirty tracking.
-    this->chunk_count_ =
-        (this->cached_width_ + kChunkWidth - 1) / kChunkWidth;
-    this->dirty_chunks_.assign(this->chunk_count_, 0);
-    size_t bufsize = this->cached_width_ * this->cached_height_ * 3;
-    this->init_internal_(bufsize);
+    // Split the panel into fixed-width chunks for dirty tracking. auto
+    // starts from the default and settles once the driver is up.
+    this->configure_chunks_(this->requested_chunk_width_ > 0
+                                ? this->requested_chunk_width_
+                                : kDefaultChunkWidth);
+    if (this->pixel_format_ == PixelFormat::RGB444 &&
+        (this->cached_width_ & 1) != 0) {
+        ESP_LOGW(TAG, "RGB444 needs an even width; using RGB565");
+        this->pixel_format_ = PixelFormat::RGB565;
+    }
+    size_t bufsize = this->fb_bytes_(static_cast<size_t>(this->cached_width_) *
+                                     this->cached_height_);
+    this->frame_bytes_ = bufsize;
+    if (this->tiled_ &&
+        (this->pixel_format_ != PixelFormat::RGB888 ||
+         !this->layout_.is_identity() || this->color_lut_active_ ||
+         this->framebuffer_location_ == BufferLocation::PSRAM)) {
+        ESP_LOGW(TAG, "Tiled framebuffer needs RGB888, internal RAM, no "
+                      "panel layout and no colour correction; using rows");
+        this->tiled_ = false;
+    }
+    if (this->tiled_) {
+        // The worker sends straight from a tiled framebuffer, so it has to
+        // be DMA-capable.
+        this->buffer_ = this->alloc_frame_(bufsize, true,
+                                           this->framebuffer_psram_);
+        if (this->buffer_ == nullptr) {
+            ESP_LOGW(TAG, "No room for a DMA-capable framebuffer; using rows");
+            this->tiled_ = false;
+        }
+    }
+    if (!this->tiled_)
+        this->buffer_ = this->alloc_frame_(bufsize, false,
+                                           this->framebuffer_psram_);
     if (this->buffer_ == nullptr) {
-        ESP_LOGE(TAG, "Framebuffer allocation failed; display not ready");
+        ESP_LOGE(TAG, "Framebuffer allocation failed (%u bytes); "
+                      "display not ready",
+                 static_cast<unsigned>(bufsize));
         return;
     }
-    // Preallocate a single DMA-capable chunk buffer reused for each flush.
-    const int max_chunk_width = std::min(kChunkWidth, this->cached_width_);
-    this->chunk_buffer_bytes_ =
-        static_cast<size_t>(max_chunk_width) * this->cached_height_ * 3;
-    this->chunk_buffer_ = static_cast<uint8_t *>(
-        heap_caps_malloc(this->chunk_buffer_bytes_, MALLOC_CAP_DMA));
-    if (this->chunk_buffer_ == nullptr) {
+    // Preallocate internal DMA-capable staging buffers, used in rotation so
+    // one can be packed while the worker transfers another.
+    // Each holds at least one full-height chunk; a larger size lets the
+    // flush merge runs of adjacent dirty chunks into one rect.
+    const int max_chunk_width =
+        std::min(this->chunk_width_, this->cached_width_);
+    const size_t frame_bytes = static_cast<size_t>(this->cached_width_) *
+                               this->cached_height_ * 3;
+    this->chunk_buffer_bytes_ = std::min(
+        frame_bytes,
+        std::max(static_cast<size_t>(max_chunk_width) * this->cached_height_ * 3,
+                 this->staging_buffer_bytes_));
+    // A tiled framebuffer is sent in place and needs no staging, bar one
+    // buffer for the calibration probe's test pattern.
+    const int staging_count = !this->tiled_         ? this->staging_buffer_count_
+                              : this->spi_calibration_ ? 1
+                                                       : 0;
+    for (int i = 0; i < staging_count; ++i) {
+        auto *staging = static_cast<uint8_t *>(
+            heap_caps_malloc(this->chunk_buffer_bytes_,
+                             MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL));
+        if (staging == nullptr)
+            break;
+        this->chunk_buffers_.push_back(staging);
+    }
+    if (this->chunk_buffers_.empty() && !this->tiled_) {
         ESP_LOGE(TAG, "Chunk buffer allocation failed; display not ready");
         return;
     }
-    this->dirty_any_ = true; // Force initial flush so FPGA matches the buffer.
+    if (!this->tiled_ && this->chunk_buffers_.size() <
+        static_cast<size_t>(this->staging_buffer_count_)) {
+        ESP_LOGW(TAG, "Only %u of %d staging buffers allocated",
+                 static_cast<unsigned>(this->chunk_buffers_.size()),
+                 this->staging_buffer_count_);
+    }
+    // Render slots offer every row of each frame to the flush, so without a
+    // diff every frame would be a full upload. Codegen defaults to hash; this
+    // covers direct setters.
+    if (this->render_task_ && this->content_diff_ == ContentDiffMode::NONE) {
+        ESP_LOGW(TAG, "Render task needs a content diff; using hash");
+        this->content_diff_ = ContentDiffMode::HASH;
+    }
+    if (this->content_diff_ == ContentDiffMode::SHADOW) {
+        this->shadow_buffer_ =
+            this->alloc_frame_(bufsize, false, this->shadow_psram_);
+        if (this->shadow_buffer_ == nullptr) {
+            this->content_diff_ = this->render_task_ ? ContentDiffMode::HASH
+                                                     : ContentDiffMode::NONE;
+            ESP_LOGW(TAG, "Shadow buffer allocation failed; content diff %s",
+                     this->render_task_ ? "hash" : "off");
+        }
+    }
+    if (this->content_diff_ == ContentDiffMode::HASH) {
+        this->row_hashes_.assign(
+            static_cast<size_t>(this->chunk_count_) * this->cached_height_, 0);
+    }
+    this->flush_buffer_ = this->buffer_;
+    if (this->render_task_) {
+        // buffer_ becomes whichever slot the render task is drawing into.
+        this->frames_[0] = this->buffer_;
+        for (uint8_t i = 1; i < kFrameSlots; ++i) {
+            this->frames_[i] =
+                this->alloc_frame_(bufsize, this->tiled_, this->frames_psram_);
+            if (this->frames_[i] == nullptr)
+                break;
+        }
+        if (this->frames_[kFrameSlots - 1] == nullptr) {
+            ESP_LOGW(TAG, "Frame slot allocation failed; rendering inline");
+            for (uint8_t i = 1; i < kFrameSlots; ++i) {
+                if (this->frames_[i] != nullptr)
+                    heap_caps_free(this->frames_[i]);
+                this->frames_[i] = nullptr;
+            }
+            this->render_task_ = false;
+        } else {
+            this->flush_buffer_ = this->frames_[this->flush_slot_];
+        }
+    }
+    this->mark_all_dirty_(); // Force initial flush so FPGA matches the buffer.
 
     // Display Setup
+    this->panel_mutex_ = xSemaphoreCreateMutex();
+    if (this->panel_mutex_ == nullptr) {
+        ESP_LOGE(TAG, "Panel mutex allocation failed; display disabled");
+        this->mark_failed();
+        return;
+    }
     dma_display_ = new MatrixPanel_FPGA_SPI(this->mxconfig_);
-    dma_display_->set_worker_core(1);
+    dma_display_->set_worker_core(this->worker_core_);
     dma_display_->enable_worker(true);
     if (!this->dma_display_->begin()) {
         ESP_LOGE(TAG, "MatrixPanel begin() failed; display disabled");
         this->mark_failed();
         return;
     }
+    const bool measured = this->measure_command_cost_();
+    if (this->requested_chunk_width_ <= 0) {
+        // Every buffer is still blank, so a tiled framebuffer needs no
+        // reshuffle for the new chunk size.
+        this->configure_chunks_(measured ? this->auto_chunk_width_()
+                                         : kDefaultChunkWidth);
+        this->mark_all_dirty_();
+    }
     if (this->mxconfig_.status_gpio.sck >= 0 &&
         !this->dma_display_->status_spi_available()) {
         ESP_LOGW(TAG, "Status SPI pins configured but init failed; "
                       "status sensors will not update");
     }
+    if (this->integrity_addr_ >= 0 &&
+        !this->dma_display_->status_spi_available()) {
+        ESP_LOGW(TAG, "Integrity check needs the status SPI; disabled");
+        this->integrity_addr_ = -1;
+    }
+    this->spi_floor_ = this->mxconfig_.spispeed;
+    // Further displays get their own slot; the first keeps the original key.
+    std::string pref_key = "fpga_matrix_display.spi_calibration";
+    if (this->instance_index_ != 0)
+        pref_key += "." + std::to_string(this->instance_index_);
+    this->spi_pref_ = global_preferences->make_preference<SpiCalibration>(
+        fnv1_hash(pref_key));
+    if (this->spi_calibration_) {
+        SpiCalibration stored;
+        // A stored clock only holds for the floor it was calibrated from;
+        // changing spispeed in the config starts a fresh calibration.
+        if (this->spi_pref_.load(&stored) &&
+            stored.floor == static_cast<uint32_t>(this->spi_floor_) &&
+            clock_step_index_(static_cast<FPGA_SPI_CFG::clk_speed>(
+                stored.speed)) >= 0) {
+            const auto speed =
+                static_cast<FPGA_SPI_CFG::clk_speed>(stored.speed);
+            ESP_LOGI(TAG, "Using calibrated SPI clock: %u MHz",
+                     static_cast<unsigned>(stored.speed / 1000000));
+            if (speed != this->mxconfig_.spispeed &&
+                !this->restart_panel_(speed)) {
+                this->mark_failed();
+                return;
+            }
+        } else {
+            this->calibrate_spi();
+        }
+    }
+    if (this->frame_pacing_) {
+        this->request_status(MatrixPanel_FPGA_SPI::STATUS_ADDR_HUB75_FPS);
+        this->request_status(MatrixPanel_FPGA_SPI::STATUS_ADDR_FB_FPS);
+    }
+    // Status registers are read in one burst off the main loop, so status
+    // sensors never wait on the SPI mutex behind a frame transfer.
+    if (this->status_poll_interval_ms_ != 0 &&
+        this->dma_display_->status_spi_available() &&
+        xTaskCreatePinnedToCore(&MatrixDisplay::status_task_fn_,
+                                "matrix_status", 4096, this, 1,
+                                &this->status_task_handle_, 0) != pdPASS) {
+        ESP_LOGW(TAG, "Status poller task creation failed; reading inline");
+        this->status_task_handle_ = nullptr;
+    }
 
     if (this->use_watchdog) {
         const esp_timer_create_args_t periodic_timer_args = {
@@ -113,44 +292,227 @@ void MatrixDisplay::setup() {
     set_brightness(this->initial_brightness_);
     this->dma_display_->clearScreen();
 
-    // Default to off if power switches are present
-    set_state(!this->power_switches_.size());
+    // Render on core 0; the main loop runs on core 1.
+    if (this->render_task_ &&
+        xTaskCreatePinnedToCore(&MatrixDisplay::render_task_fn_,
+                                "matrix_render", 8192, this, 1,
+                                &this->render_task_handle_, 0) != pdPASS) {
+        ESP_LOGW(TAG, "Render task creation failed; rendering inline");
+        this->render_task_ = false;
+    }
+
+    // Default to off if power switches are present. The panel was just
+    // cleared, so there is nothing to blank.
+    if (!this->power_switches_.empty())
+        this->enter_power_state_(PowerState::OFF);
+}
+
+void MatrixDisplay::set_state(bool state) {
+    if (!state) {
+        if (this->power_state_ != PowerState::ON)
+            return;
+        this->enter_power_state_(PowerState::BLANKING);
+        this->blank_();
+        return;
+    }
+    if (this->power_state_ == PowerState::ON)
+        return;
+    // Switched back on before the clear went out: the pass in flight just
+    // carries on.
+    const bool cleared = this->power_state_ == PowerState::OFF;
+    this->enter_power_state_(PowerState::ON);
+    if (!cleared)
+        return;
+    // The panel is blank: send the whole framebuffer once, without the
+    // content diff, instead of fills recorded while it was dark.
+    this->pending_fill_count_ = 0;
+    this->replay_cursor_ = 0;
+    this->integrity_resync_ = true;
+    this->mark_all_dirty_();
+    // Restart frame timing rather than count the dark period as jitter.
+    this->last_frame_us_ = 0;
+    this->next_frame_us_ = micros();
+}
+
+bool MatrixDisplay::resync_fpga_reset_() {
+    if (!this->dma_display_->consume_fpga_reset())
+        return false;
+    ESP_LOGW(TAG, "FPGA reset detected; resyncing display state");
+    this->dma_display_->resync_after_fpga_reset(
+        static_cast<uint8_t>(this->initial_brightness_));
+    this->integrity_resync_ = true;
+    return true;
+}
+
+void MatrixDisplay::blank_() {
+    // While the FPGA is held in reset/config, keep blanking pending.
+    if (this->dma_display_ == nullptr || !this->dma_display_->fpga_ready())
+        return;
+    if (this->flush_state_ != FlushState::IDLE) {
+        const uint32_t flush_start = micros();
+        this->flush_(flush_start + this->flush_budget_us_);
+        this->flush_stats_.flush_micros += micros() - flush_start;
+        if (this->flush_state_ != FlushState::IDLE)
+            return;
+    }
+    this->dma_display_->clearScreen();
+    this->note_command_(0);
+    this->enter_power_state_(PowerState::OFF);
+}
+
+void MatrixDisplay::enter_power_state_(PowerState state) {
+    const uint32_t now = millis();
+    const uint32_t stint = now - this->power_state_since_ms_;
+    if (this->power_state_ == PowerState::ON)
+        this->flush_stats_.on_millis += stint;
+    else
+        this->flush_stats_.off_millis += stint;
+    this->power_state_since_ms_ = now;
+    this->status_paused_.store(state == PowerState::OFF);
+    if (this->suspend_watchdog_when_off_ && this->use_watchdog &&
+        this->periodic_timer != nullptr) {
+        if (state == PowerState::OFF)
+            esp_timer_stop(this->periodic_timer);
+        else if (this->power_state_ == PowerState::OFF)
+            esp_timer_start_periodic(this->periodic_timer,
+                                     this->watchdog_interval_usec);
+    }
+    this->power_state_ = state;
+}
+
+MatrixDisplay::FlushStats MatrixDisplay::get_flush_stats() const {
+    FlushStats stats = this->flush_stats_;
+    stats.asset_hits = this->asset_hits_.load();
+    stats.asset_misses = this->asset_misses_.load();
+    const uint32_t stint = millis() - this->power_state_since_ms_;
+    if (this->power_state_ == PowerState::ON)
+        stats.on_millis += stint;
+    else
+        stats.off_millis += stint;
+    return stats;
 }
 
 /**
  * Updates the displayed image on the matrix. Dual buffers are used to prevent
  * blanking in-between frames.
  */
+void MatrixDisplay::loop() {
+    // Calibration owns the link until it settles; frames wait.
+    if (this->is_calibrating()) {
+        this->step_calibration_();
+        return;
+    }
+    // Nothing is rendered or sent while off; switching off only has to
+    // finish the pass in flight and clear the panel.
+    if (this->power_state_ != PowerState::ON) {
+        if (this->power_state_ == PowerState::BLANKING)
+            this->blank_();
+        return;
+    }
+    this->rotate_latency_window_();
+    if (this->pacing_interval_us_ != 0 && !this->test_state_active_) {
+        const uint32_t now = micros();
+        const int32_t late = static_cast<int32_t>(now - this->next_frame_us_);
+        if (late >= 0) {
+            // Slots the loop overslept are skipped rather than rendered late,
+            // so the cadence stays locked to the panel refresh.
+            const uint32_t missed =
+                static_cast<uint32_t>(late) / this->pacing_interval_us_;
+            this->next_frame_us_ += (missed + 1) * this->pacing_interval_us_;
+            this->flush_stats_.dropped += missed;
+            // Under SPI backpressure drop the slot instead of letting the
+            // writer queue up behind the pending pass. The render task keeps
+            // drawing and drops stale frames on its own.
+            if (this->flush_state_ != FlushState::IDLE &&
+                this->render_task_handle_ == nullptr) {
+                this->flush_stats_.dropped++;
+                this->frame_skipped_ = true;
+            } else {
+                if (missed != 0)
+                    this->frame_skipped_ = true;
+                this->run_frame_();
+                return;
+            }
+        }
+    }
+    // Continue a budgeted flush between update() calls.
+    if (this->flush_state_ == FlushState::IDLE || this->test_state_active_ ||
+        this->dma_display_ == nullptr ||
+        !this->dma_display_->fpga_ready())
+        return;
+    uint32_t flush_start = micros();
+    this->flush_(flush_start + this->flush_budget_us_);
+    this->flush_stats_.flush_micros += micros() - flush_start;
+}
+
 void MatrixDisplay::update() {
     if (this->test_state_active_) {
         this->run_test_state_sequence_();
         return;
     }
+    if (this->is_calibrating())
+        return;
+    if (this->power_state_ != PowerState::ON) {
+        // Nothing is drawn, but an FPGA that reset while dark still needs
+        // its state restored. With the watchdog suspended, that reset is
+        // expected rather than a link error.
+        if (this->dma_display_ != nullptr &&
+            this->dma_display_->fpga_ready() && this->resync_fpga_reset_() &&
+            !this->suspend_watchdog_when_off_)
+            this->note_link_error_();
+        return;
+    }
+    // With frame pacing, loop() runs the frames on the panel's cadence and
+    // the poller only retunes it.
+    if (this->frame_pacing_) {
+        this->refresh_pacing_();
+        return;
+    }
+    this->run_frame_();
+}
 
+void MatrixDisplay::run_frame_() {
     // While the FPGA is held in reset/config, don't drive it over SPI --
     // doing so stalls on its handshake pins and can stall the main loop.
     if (this->dma_display_ != nullptr && !this->dma_display_->fpga_ready())
         return;
 
     uint32_t start_time = micros();
-    if (this->dma_display_ != nullptr &&
-        this->dma_display_->consume_fpga_reset()) {
-        ESP_LOGW(TAG, "FPGA reset detected; resyncing display state");
-        this->dma_display_->resync_after_fpga_reset(
-            static_cast<uint8_t>(this->initial_brightness_));
-    }
-    // uint32_t update_end_time, update_start_time;
-    if (this->enabled_) {
-        // Draw updates to the screen
-        // update_start_time = micros();
+    const uint64_t target_us =
+        this->pacing_interval_us_ != 0
+            ? this->pacing_interval_us_
+            : static_cast<uint64_t>(this->update_interval_) * 1000;
+    if (this->last_frame_us_ != 0 && !this->frame_skipped_) {
+        const int64_t error =
+            static_cast<int64_t>(start_time - this->last_frame_us_) -
+            static_cast<int64_t>(target_us);
+        this->flush_stats_.jitter_micros +=
+            static_cast<uint64_t>(error < 0 ? -error : error);
+        this->flush_stats_.jitter_samples++;
+    }
+    this->last_frame_us_ = start_time;
+    this->frame_skipped_ = false;
+    if (this->dma_display_ != nullptr && this->resync_fpga_reset_())
+        this->note_link_error_();
+    if (this->link_step_down_pending_ &&
+        this->flush_state_ == FlushState::IDLE)
+        this->step_down_spi_();
+    this->flush_stats_.frames++;
+    // Draw updates to the screen. While a budgeted pass is still sending the
+    // previous frame the writer is held back, so that frame is committed
+    // whole before the next one is drawn over it. The render task draws into
+    // a slot of its own and never has to wait.
+    if (this->render_task_handle_ != nullptr) {
+        xTaskNotifyGive(this->render_task_handle_);
+    } else if (this->flush_state_ == FlushState::IDLE &&
+               !this->tiled_in_use_()) {
+        const uint32_t render_start = micros();
         this->do_update_();
-        // update_end_time = micros();
-        write_display_data();
-        // size_t bufsize = this->cached_width_ * this->cached_height_ * 3;
-        // memset(this->buffer_, 0x00, bufsize);
-    } else {
-        this->dma_display_->clearScreen();
+        this->record_phase_(LatencyPhase::RENDER, micros() - render_start);
     }
+    uint32_t flush_start = micros();
+    this->flush_(start_time + this->flush_budget_us_);
+    this->flush_stats_.flush_micros += micros() - flush_start;
     uint32_t end_time = micros();
     uint32_t elapsed_time = end_time - start_time;
     // Feed the FIFO so the update-duration sensor can report a moving average
@@ -158,6 +520,81 @@ void MatrixDisplay::update() {
     this->push_update_micros_(elapsed_time);
 }
 
+void MatrixDisplay::rotate_latency_window_() {
+    const uint32_t now = millis();
+    if (now - this->latency_window_start_ms_ < this->latency_window_ms_)
+        return;
+    this->latency_window_start_ms_ = now;
+    for (size_t i = 0; i < kLatencyPhases; ++i) {
+        this->latency_window_[i] = this->latency_current_[i];
+        this->latency_current_[i].clear();
+    }
+}
+
+void MatrixDisplay::refresh_pacing_() {
+    const uint32_t now = millis();
+    const uint32_t window_ms = now - this->last_pacing_refresh_ms_;
+    if (this->pacing_interval_us_ != 0 && window_ms < kPacingRefreshMs)
+        return;
+    this->last_pacing_refresh_ms_ = now;
+
+    const uint32_t requested_us = this->update_interval_ * 1000;
+    uint64_t hub75_fps = 0;
+    uint64_t fb_fps = 0;
+    if (this->dma_display_ != nullptr &&
+        this->dma_display_->status_spi_available()) {
+        if (this->read_status_value(MatrixPanel_FPGA_SPI::STATUS_ADDR_HUB75_FPS,
+                                    hub75_fps) &&
+            hub75_fps > 0) {
+            this->pacing_period_us_ = static_cast<uint32_t>(1000000 / hub75_fps);
+        }
+        this->read_status_value(MatrixPanel_FPGA_SPI::STATUS_ADDR_FB_FPS,
+                                fb_fps);
+    }
+    // Without a refresh rate, pace on update_interval alone.
+    const uint32_t period_us =
+        this->pacing_period_us_ != 0 ? this->pacing_period_us_ : requested_us;
+    // Smallest whole number of refreshes that honours update_interval, so
+    // every frame stays up for the same number of panel scans.
+    const uint32_t base =
+        std::max<uint32_t>(1, (requested_us + period_us - 1) / period_us);
+
+    // Back off while the last window shows the flush can't keep up: slots
+    // dropped, or more commits than the FPGA reports swapping. Step back
+    // towards the requested rate once a window is clean.
+    if (this->pacing_interval_us_ != 0) {
+        const FlushStats &stats = this->flush_stats_;
+        const uint32_t dropped = stats.dropped - this->pacing_window_.dropped;
+        const uint32_t slots =
+            stats.frames - this->pacing_window_.frames + dropped;
+        const uint32_t commits = stats.commits - this->pacing_window_.commits;
+        const bool fb_lagging =
+            fb_fps > 0 && static_cast<uint64_t>(commits) * 1000 >
+                              fb_fps * window_ms * 11 / 10;
+        if ((dropped * 10 > slots || fb_lagging) &&
+            this->pacing_multiplier_ < base * kMaxPacingBackoff) {
+            this->pacing_multiplier_++;
+        } else if (dropped == 0 && this->pacing_multiplier_ > base) {
+            this->pacing_multiplier_--;
+        }
+    }
+    this->pacing_window_ = this->flush_stats_;
+    this->pacing_multiplier_ = std::max(this->pacing_multiplier_, base);
+
+    const uint32_t interval = this->pacing_multiplier_ * period_us;
+    if (interval != this->pacing_interval_us_) {
+        ESP_LOGD(TAG, "Frame pacing: %u us (%u x %u us refresh)",
+                 static_cast<unsigned>(interval),
+                 static_cast<unsigned>(this->pacing_multiplier_),
+                 static_cast<unsigned>(period_us));
+        if (this->pacing_interval_us_ == 0) {
+            this->next_frame_us_ = micros();
+            this->high_freq_.start();
+        }
+        this->pacing_interval_us_ = interval;
+    }
+}
+
 void MatrixDisplay::dump_config() {
     ESP_LOGCONFIG(TAG, "MatrixDisplay:");
 
@@ -186,6 +623,75 @@ void MatrixDisplay::dump_config() {
     ESP_LOGCONFIG(TAG, "  width: %i", cfg.mx_width);
     ESP_LOGCONFIG(TAG, "  height: %i", cfg.mx_height);
     ESP_LOGCONFIG(TAG, "  chain_length: %i", cfg.chain_length);
+    if (this->layout_rows_ > 1 || !this->layout_.is_identity()) {
+        ESP_LOGCONFIG(TAG, "  Layout: %i x %i panels%s%s",
+                      this->layout_.columns(), this->layout_.rows(),
+                      this->layout_.serpentine() ? ", serpentine" : "",
+                      this->layout_.is_identity() ? "" : ", remapped");
+    }
+    ESP_LOGCONFIG(TAG, "  Pixel format: %s",
+                  this->pixel_format_ == PixelFormat::RGB565   ? "RGB565"
+                  : this->pixel_format_ == PixelFormat::RGB444 ? "RGB444"
+                                                               : "RGB888");
+    ESP_LOGCONFIG(TAG, "  Content diff: %s",
+                  this->content_diff_ == ContentDiffMode::SHADOW ? "shadow"
+                  : this->content_diff_ == ContentDiffMode::HASH ? "hash"
+                                                                 : "none");
+    ESP_LOGCONFIG(TAG, "  Compress rects: %s",
+                  YESNO(this->compress_rects_));
+    ESP_LOGCONFIG(TAG, "  Command overhead: %u bytes",
+                  static_cast<unsigned>(this->command_overhead_bytes_));
+    ESP_LOGCONFIG(TAG, "  Chunk width: %i%s (%i chunks)", this->chunk_width_,
+                  this->requested_chunk_width_ > 0 ? "" : " (auto)",
+                  this->chunk_count_);
+    ESP_LOGCONFIG(TAG, "  Framebuffer: %u bytes in %s",
+                  static_cast<unsigned>(this->frame_bytes_),
+                  this->framebuffer_psram_ ? "PSRAM" : "internal RAM");
+    if (this->shadow_buffer_ != nullptr) {
+        ESP_LOGCONFIG(TAG, "  Shadow buffer: %u bytes in %s",
+                      static_cast<unsigned>(this->frame_bytes_),
+                      this->shadow_psram_ ? "PSRAM" : "internal RAM");
+    }
+    if (this->render_task_) {
+        ESP_LOGCONFIG(TAG, "  Render slots: %u x %u bytes in %s",
+                      static_cast<unsigned>(kFrameSlots - 1),
+                      static_cast<unsigned>(this->frame_bytes_),
+                      this->frames_psram_ ? "PSRAM" : "internal RAM");
+    }
+    if (this->use_watchdog) {
+        ESP_LOGCONFIG(TAG, "  Watchdog while off: %s",
+                      this->suspend_watchdog_when_off_ ? "suspended" : "fed");
+    }
+    ESP_LOGCONFIG(TAG, "  Asset cache: %u bytes",
+                  static_cast<unsigned>(this->asset_cache_bytes_));
+    if (this->tiled_) {
+        ESP_LOGCONFIG(TAG, "  Framebuffer layout: tiled (sent in place, "
+                           "no staging buffers)");
+    } else {
+        ESP_LOGCONFIG(TAG,
+                      "  Staging buffers: %u x %u bytes in internal DMA RAM "
+                      "(max merged rect)",
+                      static_cast<unsigned>(this->chunk_buffers_.size()),
+                      static_cast<unsigned>(this->chunk_buffer_bytes_));
+    }
+    ESP_LOGCONFIG(TAG, "  Worker core: %i", this->worker_core_);
+    ESP_LOGCONFIG(TAG, "  Render task: %s", YESNO(this->render_task_));
+    ESP_LOGCONFIG(TAG, "  SPI calibration: %s", YESNO(this->spi_calibration_));
+    if (this->integrity_addr_ >= 0) {
+        ESP_LOGCONFIG(TAG, "  Integrity register: 0x%02X",
+                      static_cast<unsigned>(this->integrity_addr_));
+    }
+    ESP_LOGCONFIG(TAG, "  Frame pacing: %s", YESNO(this->frame_pacing_));
+    if (this->status_task_handle_ != nullptr) {
+        ESP_LOGCONFIG(TAG, "  Status poller: every %u ms",
+                      static_cast<unsigned>(this->status_poll_interval_ms_));
+    }
+    if (this->flush_budget_us_ != 0) {
+        ESP_LOGCONFIG(TAG, "  Flush budget: %u us",
+                      static_cast<unsigned>(this->flush_budget_us_));
+    } else {
+        ESP_LOGCONFIG(TAG, "  Flush budget: unlimited");
+    }
 }
 
 void MatrixDisplay::log_status_read_failure_() {
@@ -201,6 +707,14 @@ bool MatrixDisplay::read_status_flags(
     MatrixPanel_FPGA_SPI::FpgaStatusFlags &out) {
     if (this->dma_display_ == nullptr)
         return false;
+    if (this->status_task_handle_ != nullptr) {
+        StatusSnapshot snapshot;
+        if (!this->load_status_(MatrixPanel_FPGA_SPI::STATUS_ADDR_FLAGS,
+                                snapshot))
+            return false;
+        out = snapshot.flags;
+        return true;
+    }
     if (this->dma_display_->readFlags(out))
         return true;
     this->log_status_read_failure_();
@@ -210,7 +724,18 @@ bool MatrixDisplay::read_status_flags(
 bool MatrixDisplay::read_status_value(uint8_t addr, uint64_t &out) {
     if (this->dma_display_ == nullptr)
         return false;
-    if (this->dma_display_->readStatus(addr, out))
+    if (this->status_task_handle_ != nullptr && addr < kStatusSlots) {
+        StatusSnapshot snapshot;
+        if (!this->load_status_(addr, snapshot))
+            return false;
+        out = snapshot.values[addr];
+        return true;
+    }
+    // The status poller shares the status SPI.
+    xSemaphoreTake(this->panel_mutex_, portMAX_DELAY);
+    const bool ok = this->dma_display_->readStatus(addr, out);
+    xSemaphoreGive(this->panel_mutex_);
+    if (ok)
         return true;
     this->log_status_read_failure_();
     return false;
@@ -219,12 +744,376 @@ bool MatrixDisplay::read_status_value(uint8_t addr, uint64_t &out) {
 bool MatrixDisplay::read_version(MatrixPanel_FPGA_SPI::FpgaVersion &out) {
     if (this->dma_display_ == nullptr)
         return false;
+    if (this->status_task_handle_ != nullptr) {
+        StatusSnapshot snapshot;
+        if (!this->load_status_(MatrixPanel_FPGA_SPI::STATUS_ADDR_VERSION,
+                                snapshot))
+            return false;
+        out = snapshot.version;
+        return true;
+    }
     if (this->dma_display_->readVersion(out))
         return true;
     this->log_status_read_failure_();
     return false;
 }
 
+int MatrixDisplay::clock_step_index_(FPGA_SPI_CFG::clk_speed speed) {
+    for (int i = 0; i < kClockStepCount; ++i) {
+        if (kClockSteps[i] == speed)
+            return i;
+    }
+    return -1;
+}
+
+bool MatrixDisplay::restart_panel_(FPGA_SPI_CFG::clk_speed speed) {
+    if (!this->quiesce_driver_()) {
+        ESP_LOGW(TAG, "SPI worker still busy; keeping %u MHz",
+                 static_cast<unsigned>(this->mxconfig_.spispeed / 1000000));
+        return false;
+    }
+    // Keep the status poller and the watchdog timer off the driver while it
+    // is swapped out.
+    xSemaphoreTake(this->panel_mutex_, portMAX_DELAY);
+    if (this->use_watchdog && this->periodic_timer != nullptr)
+        esp_timer_stop(this->periodic_timer);
+    delete this->dma_display_;
+    this->mxconfig_.spispeed = speed;
+    this->dma_display_ = new MatrixPanel_FPGA_SPI(this->mxconfig_);
+    this->dma_display_->set_worker_core(this->worker_core_);
+    this->dma_display_->enable_worker(true);
+    const bool ok = this->dma_display_->begin();
+    if (ok) {
+        // The fixed cost per command in payload bytes scales with the clock.
+        this->measure_command_cost_();
+        this->dma_display_->setBrightness8(
+            static_cast<uint8_t>(this->current_brightness_));
+        this->dma_display_->clearScreen();
+    } else {
+        ESP_LOGE(TAG, "MatrixPanel begin() failed at %u MHz",
+                 static_cast<unsigned>(speed / 1000000));
+    }
+    // A watchdog suspended while off stays suspended.
+    if (this->use_watchdog && this->periodic_timer != nullptr &&
+        !(this->suspend_watchdog_when_off_ &&
+          this->power_state_ == PowerState::OFF))
+        esp_timer_start_periodic(this->periodic_timer,
+                                 this->watchdog_interval_usec);
+    xSemaphoreGive(this->panel_mutex_);
+    // The new driver starts from a cleared panel: drop any pass in flight
+    // and send the whole framebuffer again.
+    this->flush_state_ = FlushState::IDLE;
+    this->flush_start_chunk_ = 0;
+    this->in_flight_count_ = 0;
+    this->worker_waiting_ = false;
+    this->tiled_hold_ = false;
+    this->pending_fill_count_ = 0;
+    this->replay_cursor_ = 0;
+    this->integrity_resync_ = true;
+    this->mark_all_dirty_();
+    return ok;
+}
+
+bool MatrixDisplay::quiesce_driver_() {
+    // A tiled framebuffer or a staging buffer may still be on the wire.
+    const uint32_t start = millis();
+    while (!this->dma_display_->worker_is_idle()) {
+        if (millis() - start > this->worker_idle_timeout_ms_)
+            return false;
+        vTaskDelay(1);
+    }
+    // Stop the worker taking new jobs before its task is torn down.
+    this->dma_display_->enable_worker(false);
+    return true;
+}
+
+void MatrixDisplay::begin_probe_() {
+    this->probe_epoch_ = this->dma_display_->get_reset_epoch();
+    this->probe_check_sum_ =
+        this->integrity_addr_ >= 0 && this->resync_integrity_();
+    this->probe_sent_ = 0;
+    this->probe_x_ = 0;
+    this->probe_start_ms_ = millis();
+    this->probe_send_ms_ = this->probe_start_ms_;
+}
+
+MatrixDisplay::ProbeStatus MatrixDisplay::step_probe_(uint32_t deadline) {
+    if (this->chunk_buffers_.empty())
+        return ProbeStatus::FAILED;
+    // One full-height chunk of a byte pattern that toggles every data line,
+    // walked along the chain itself rather than the logical canvas.
+    const int chain_width =
+        this->mxconfig_.mx_width * this->mxconfig_.chain_length;
+    const int w = std::min(this->chunk_width_, chain_width);
+    const int h = this->mxconfig_.mx_height;
+    const size_t bytes = static_cast<size_t>(w) * h * 3;
+    uint8_t *staging = this->chunk_buffers_[0];
+    while (millis() - this->probe_start_ms_ < kProbeMs) {
+        if (!this->dma_display_->worker_is_idle()) {
+            if (millis() - this->probe_send_ms_ >
+                this->worker_idle_timeout_ms_) {
+                ESP_LOGD(TAG, "SPI probe: worker stalled");
+                return ProbeStatus::FAILED;
+            }
+            if (static_cast<int32_t>(millis() - deadline) >= 0)
+                return ProbeStatus::RUNNING;
+            vTaskDelay(1);
+            continue;
+        }
+        if (static_cast<int32_t>(millis() - deadline) >= 0)
+            return ProbeStatus::RUNNING;
+        for (size_t i = 0; i < bytes; ++i)
+            staging[i] = static_cast<uint8_t>((i * 37 + this->probe_sent_) ^ 0xA5);
+        this->dma_display_->drawRectRGB888_prealloc(this->probe_x_, 0, w, h,
+                                                    staging, bytes);
+        if (this->probe_check_sum_)
+            this->integrity_expected_ += payload_sum(staging, bytes);
+        this->probe_sent_ += bytes;
+        this->probe_send_ms_ = millis();
+        this->probe_x_ =
+            this->probe_x_ + w >= chain_width ? 0 : this->probe_x_ + w;
+    }
+    // The last rect has to land before the FPGA's counters are read.
+    if (!this->dma_display_->worker_is_idle()) {
+        if (millis() - this->probe_send_ms_ > this->worker_idle_timeout_ms_) {
+            ESP_LOGD(TAG, "SPI probe: worker stalled");
+            return ProbeStatus::FAILED;
+        }
+        return ProbeStatus::RUNNING;
+    }
+    const uint32_t elapsed_ms =
+        std::max<uint32_t>(1, millis() - this->probe_start_ms_);
+    // bytes per ms is kB/s, the unit STATUS_ADDR_RX_KBPS reports in.
+    const uint64_t tx_kbps = this->probe_sent_ / elapsed_ms;
+    uint64_t rx_kbps = 0;
+    MatrixPanel_FPGA_SPI::FpgaStatusFlags flags;
+    // The status poller shares the status SPI.
+    xSemaphoreTake(this->panel_mutex_, portMAX_DELAY);
+    const bool read =
+        this->dma_display_->readStatus(
+            MatrixPanel_FPGA_SPI::STATUS_ADDR_RX_KBPS, rx_kbps) &&
+        this->dma_display_->readFlags(flags);
+    xSemaphoreGive(this->panel_mutex_);
+    if (!read) {
+        this->log_status_read_failure_();
+        return ProbeStatus::FAILED;
+    }
+    ESP_LOGD(TAG, "SPI probe: sent %u kB/s, FPGA received %u kB/s",
+             static_cast<unsigned>(tx_kbps), static_cast<unsigned>(rx_kbps));
+    if (this->probe_check_sum_) {
+        const uint32_t expected = this->integrity_expected_;
+        if (!this->resync_integrity_() ||
+            this->integrity_expected_ != expected) {
+            ESP_LOGD(TAG, "SPI probe: payload checksum mismatch");
+            return ProbeStatus::FAILED;
+        }
+    }
+    return flags.fpga_ready &&
+                   this->dma_display_->get_reset_epoch() == this->probe_epoch_ &&
+                   rx_kbps * 100 >= tx_kbps * kProbeMinRxPercent
+               ? ProbeStatus::PASSED
+               : ProbeStatus::FAILED;
+}
+
+bool MatrixDisplay::calibrate_spi() {
+    if (this->is_calibrating())
+        return true;
+    if (this->dma_display_ == nullptr ||
+        !this->dma_display_->status_spi_available()) {
+        ESP_LOGW(TAG, "SPI calibration needs the status SPI; skipped");
+        return false;
+    }
+    const int floor = clock_step_index_(this->spi_floor_);
+    if (floor < 0)
+        return false;
+    ESP_LOGI(TAG, "Calibrating SPI clock from %u MHz",
+             static_cast<unsigned>(this->spi_floor_ / 1000000));
+    this->calibration_floor_ = floor;
+    this->calibration_step_ = floor;
+    this->calibration_best_ = -1;
+    this->calibration_stage_ = CalibrationStage::RESTART;
+    return true;
+}
+
+void MatrixDisplay::step_calibration_() {
+    switch (this->calibration_stage_) {
+    case CalibrationStage::IDLE:
+        break;
+    case CalibrationStage::RESTART:
+        if (this->restart_panel_(kClockSteps[this->calibration_step_])) {
+            this->begin_probe_();
+            this->calibration_stage_ = CalibrationStage::PROBE;
+        } else {
+            ESP_LOGI(TAG, "  %u MHz: failed",
+                     static_cast<unsigned>(
+                         kClockSteps[this->calibration_step_] / 1000000));
+            this->calibration_stage_ = CalibrationStage::FINISH;
+        }
+        break;
+    case CalibrationStage::PROBE: {
+        const ProbeStatus status =
+            this->step_probe_(millis() + kCalibrationSliceMs);
+        if (status == ProbeStatus::RUNNING)
+            break;
+        const unsigned mhz = static_cast<unsigned>(
+            kClockSteps[this->calibration_step_] / 1000000);
+        // Faster clocks only get worse, so stop at the first failing one.
+        if (status == ProbeStatus::FAILED) {
+            ESP_LOGI(TAG, "  %u MHz: failed", mhz);
+            this->calibration_stage_ = CalibrationStage::FINISH;
+            break;
+        }
+        ESP_LOGI(TAG, "  %u MHz: ok", mhz);
+        this->calibration_best_ = this->calibration_step_;
+        this->calibration_stage_ = ++this->calibration_step_ < kClockStepCount
+                                       ? CalibrationStage::RESTART
+                                       : CalibrationStage::FINISH;
+        break;
+    }
+    case CalibrationStage::FINISH:
+        this->finish_calibration_();
+        break;
+    }
+}
+
+void MatrixDisplay::finish_calibration_() {
+    this->calibration_stage_ = CalibrationStage::IDLE;
+    // The configured floor is known good even if its probe failed.
+    const int chosen = std::max(this->calibration_floor_,
+                                this->calibration_best_ - kCalibrationMargin);
+    const FPGA_SPI_CFG::clk_speed speed = kClockSteps[chosen];
+    if (!this->restart_panel_(speed))
+        return;
+    this->link_errors_ = 0;
+    if (this->calibration_best_ < 0) {
+        ESP_LOGW(TAG, "SPI calibration failed; keeping %u MHz",
+                 static_cast<unsigned>(speed / 1000000));
+        return;
+    }
+    const SpiCalibration stored{static_cast<uint32_t>(speed),
+                                static_cast<uint32_t>(this->spi_floor_)};
+    this->spi_pref_.save(&stored);
+    ESP_LOGI(TAG, "SPI clock calibrated to %u MHz",
+             static_cast<unsigned>(speed / 1000000));
+}
+
+void MatrixDisplay::note_link_error_() {
+    if (!this->spi_calibration_)
+        return;
+    const uint32_t now = millis();
+    if (now - this->link_error_window_start_ms_ > kLinkErrorWindowMs) {
+        this->link_error_window_start_ms_ = now;
+        this->link_errors_ = 0;
+    }
+    if (++this->link_errors_ >= kLinkErrorThreshold) {
+        this->link_errors_ = 0;
+        this->link_step_down_pending_ = true;
+    }
+}
+
+void MatrixDisplay::step_down_spi_() {
+    this->link_step_down_pending_ = false;
+    const int index = clock_step_index_(this->mxconfig_.spispeed);
+    if (index <= 0)
+        return;
+    const FPGA_SPI_CFG::clk_speed speed = kClockSteps[index - 1];
+    ESP_LOGW(TAG, "Repeated SPI link errors; lowering clock to %u MHz",
+             static_cast<unsigned>(speed / 1000000));
+    if (!this->restart_panel_(speed))
+        return;
+    const SpiCalibration stored{static_cast<uint32_t>(speed),
+                                static_cast<uint32_t>(this->spi_floor_)};
+    this->spi_pref_.save(&stored);
+}
+
+void MatrixDisplay::status_task_fn_(void *arg) {
+    auto *self = static_cast<MatrixDisplay *>(arg);
+    for (;;) {
+        self->poll_status_();
+        vTaskDelay(pdMS_TO_TICKS(self->status_poll_interval_ms_));
+    }
+}
+
+void MatrixDisplay::poll_status_() {
+    // Readers keep the last snapshot while the display is off.
+    if (this->status_paused_.load())
+        return;
+    const uint32_t wanted = this->status_wanted_.load();
+    StatusSnapshot next;
+    xSemaphoreTake(this->panel_mutex_, portMAX_DELAY);
+    // While the FPGA is held in reset/config every register reads as failed,
+    // so readers keep their last state, as with a failed direct read.
+    if (wanted != 0 && this->dma_display_->fpga_ready()) {
+        for (uint8_t addr = 0; addr < kStatusSlots; ++addr) {
+            if ((wanted & (1u << addr)) == 0)
+                continue;
+            bool ok;
+            if (addr == MatrixPanel_FPGA_SPI::STATUS_ADDR_FLAGS)
+                ok = this->dma_display_->readFlags(next.flags);
+            else if (addr == MatrixPanel_FPGA_SPI::STATUS_ADDR_VERSION)
+                ok = this->dma_display_->readVersion(next.version);
+            else
+                ok = this->dma_display_->readStatus(addr, next.values[addr]);
+            if (ok)
+                next.valid |= 1u << addr;
+            else
+                this->log_status_read_failure_();
+        }
+    }
+    xSemaphoreGive(this->panel_mutex_);
+    // Seqlock write: readers that overlap it see an odd or changed sequence
+    // and copy again.
+    this->status_seq_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    this->status_snapshot_ = next;
+    this->status_seq_.fetch_add(1, std::memory_order_release);
+}
+
+bool MatrixDisplay::load_status_(uint8_t addr, StatusSnapshot &out) {
+    this->request_status(addr);
+    // The poller holds the sequence odd only for the length of one struct
+    // copy; give up (as a failed read) only if it was preempted mid-copy.
+    const uint32_t start = micros();
+    while (micros() - start < kStatusLoadSpinMicros) {
+        const uint32_t before = this->status_seq_.load(std::memory_order_acquire);
+        if ((before & 1) != 0)
+            continue;
+        out = this->status_snapshot_;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (this->status_seq_.load(std::memory_order_relaxed) == before)
+            return (out.valid & (1u << addr)) != 0;
+    }
+    return false;
+}
+
+void MatrixDisplay::set_color_correction(float gamma, float red, float green,
+                                         float blue) {
+    if (this->tiled_ && this->buffer_ != nullptr) {
+        ESP_LOGW(TAG, "Colour correction is unavailable with a tiled "
+                      "framebuffer");
+        return;
+    }
+    const float gains[3] = {red, green, blue};
+    bool identity = true;
+    for (int channel = 0; channel < 3; ++channel) {
+        const float gain = clamp(gains[channel], 0.0f, 1.0f);
+        for (int v = 0; v < 256; ++v) {
+            const float level = std::pow(v / 255.0f, gamma) * gain;
+            const uint8_t out = static_cast<uint8_t>(
+                clamp(std::lround(level * 255.0f), 0L, 255L));
+            this->color_lut_[channel][v] = out;
+            identity = identity && out == v;
+        }
+    }
+    const bool active = !identity;
+    if (!active && !this->color_lut_active_)
+        return;
+    this->color_lut_active_ = active;
+    // The diff reference holds framebuffer contents, which did not change;
+    // every chunk has to go out again regardless.
+    this->mark_all_dirty_();
+}
+
 void MatrixDisplay::set_brightness(int brightness) {
     // Wrap brightness function
     brightness = clamp(brightness, 0, 255);
@@ -232,121 +1121,1444 @@ void MatrixDisplay::set_brightness(int brightness) {
     this->dma_display_->setBrightness8(brightness);
 }
 
+void HOT MatrixDisplay::store_pixel_to_(uint8_t *fb, size_t index,
+                                        Color color) const {
+    switch (this->pixel_format_) {
+    case PixelFormat::RGB888: {
+        uint8_t *px = fb + index * 3;
+        px[0] = color.red;
+        px[1] = color.green;
+        px[2] = color.blue;
+        break;
+    }
+    case PixelFormat::RGB565: {
+        const uint16_t v = ((color.red & 0xF8) << 8) |
+                           ((color.green & 0xFC) << 3) | (color.blue >> 3);
+        uint8_t *px = fb + index * 2;
+        px[0] = static_cast<uint8_t>(v);
+        px[1] = static_cast<uint8_t>(v >> 8);
+        break;
+    }
+    case PixelFormat::RGB444: {
+        // Pixel pairs share three bytes; the odd pixel starts mid-byte.
+        uint8_t *px = fb + (index >> 1) * 3;
+        if ((index & 1) == 0) {
+            px[0] = (color.red & 0xF0) | (color.green >> 4);
+            px[1] = (color.blue & 0xF0) | (px[1] & 0x0F);
+        } else {
+            px[1] = (px[1] & 0xF0) | (color.red >> 4);
+            px[2] = (color.green & 0xF0) | (color.blue >> 4);
+        }
+        break;
+    }
+    }
+}
+
+Color MatrixDisplay::load_pixel_(const uint8_t *fb, size_t index) const {
+    switch (this->pixel_format_) {
+    case PixelFormat::RGB565: {
+        const uint8_t *px = fb + index * 2;
+        const uint16_t v = px[0] | (px[1] << 8);
+        return Color((v >> 8) & 0xF8, (v >> 3) & 0xFC, (v << 3) & 0xF8);
+    }
+    case PixelFormat::RGB444: {
+        const uint8_t *px = fb + (index >> 1) * 3;
+        if ((index & 1) == 0)
+            return Color(px[0] & 0xF0, px[0] << 4, px[1] & 0xF0);
+        return Color(px[1] << 4, px[2] & 0xF0, px[2] << 4);
+    }
+    case PixelFormat::RGB888:
+    default: {
+        const uint8_t *px = fb + index * 3;
+        return Color(px[0], px[1], px[2]);
+    }
+    }
+}
+
 void HOT MatrixDisplay::draw_absolute_pixel_internal(int x, int y,
                                                      Color color) {
     if (x < 0 || x >= this->cached_width_ || y < 0 || y >= this->cached_height_)
         return;
-    const int i = (y * this->cached_width_ + x) * 3;
-    this->buffer_[i + 0] = color.red;
-    this->buffer_[i + 1] = color.green;
-    this->buffer_[i + 2] = color.blue;
-    // Track dirty state at the chunk level to avoid per-column updates.
+    this->store_pixel_(this->pixel_index_(x, y), color);
+    if (this->render_task_)
+        return;
+    // Track dirty state per chunk as a row range, so a flush only sends the
+    // rows that were touched rather than the full panel height.
     if (!this->dirty_chunks_.empty()) {
-        const size_t chunk = static_cast<size_t>(x / kChunkWidth);
-        this->dirty_chunks_[chunk] = 1;
+        const size_t chunk = static_cast<size_t>(x >> this->chunk_shift_);
+        this->dirty_chunks_[chunk].mark(y);
     }
     // Any pixel write means at least one chunk must be flushed.
     this->dirty_any_ = true;
 };
+
+void MatrixDisplay::mark_rect_dirty_(int x, int y, int w, int h) {
+    if (this->render_task_ || this->dirty_chunks_.empty() || w <= 0 || h <= 0)
+        return;
+    const int first = x >> this->chunk_shift_;
+    const int last = (x + w - 1) >> this->chunk_shift_;
+    for (int chunk = first; chunk <= last; ++chunk) {
+        ChunkDirty &dirty = this->dirty_chunks_[static_cast<size_t>(chunk)];
+        dirty.mark(y);
+        dirty.mark(y + h - 1);
+    }
+    this->dirty_any_ = true;
+}
+
+void MatrixDisplay::fill_span_(size_t index, int w, Color color) {
+    if (this->pixel_format_ == PixelFormat::RGB444) {
+        // The pattern below works on whole pixel pairs; odd ends go singly.
+        if ((index & 1) != 0) {
+            this->store_pixel_(index++, color);
+            w--;
+        }
+        if ((w & 1) != 0)
+            this->store_pixel_(index + w - 1, color);
+        w &= ~1;
+    }
+    if (w <= 0)
+        return;
+    // Store one pattern unit (a pixel, or a pair for RGB444), then double
+    // it with memcpy until the span is full.
+    const int unit_pixels = this->pixel_format_ == PixelFormat::RGB444 ? 2 : 1;
+    this->store_pixel_(index, color);
+    if (unit_pixels == 2)
+        this->store_pixel_(index + 1, color);
+    uint8_t *dst = this->buffer_ + this->fb_bytes_(index);
+    const size_t total = this->fb_bytes_(static_cast<size_t>(w));
+    size_t filled = this->fb_bytes_(static_cast<size_t>(unit_pixels));
+    while (filled < total) {
+        const size_t copy = std::min(filled, total - filled);
+        std::memcpy(dst + filled, dst, copy);
+        filled += copy;
+    }
+}
+
+void MatrixDisplay::fill(Color color) {
+    if (this->foreign_draw_("fill"))
+        return;
+    // Clipped fills must honour the clip rect; leave those to the base.
+    if (this->buffer_ == nullptr || this->is_clipping()) {
+        display::DisplayBuffer::fill(color);
+        return;
+    }
+    // The framebuffer is contiguous, so one span covers every pixel in
+    // either layout.
+    this->fill_span_(0, this->cached_width_ * this->cached_height_, color);
+    if (this->content_diff_ != ContentDiffMode::NONE || this->render_task_) {
+        // Let the diff decide which rows actually changed.
+        this->mark_rect_dirty_(0, 0, this->cached_width_, this->cached_height_);
+        return;
+    }
+    // A screen fill supersedes every earlier draw and fill this frame.
+    for (ChunkDirty &dirty : this->dirty_chunks_)
+        dirty.clear();
+    // Mid-replay, the cursor restarts so this fill still goes out in the
+    // pass in flight.
+    this->pending_fill_count_ = 0;
+    this->replay_cursor_ = 0;
+    this->record_fill_(0, 0, this->cached_width_, this->cached_height_, color);
+}
+
+void MatrixDisplay::fill_rect(int x, int y, int w, int h, Color color) {
+    if (this->foreign_draw_("fill_rect"))
+        return;
+    if (this->buffer_ == nullptr || this->is_clipping() ||
+        this->get_rotation() != display::DISPLAY_ROTATION_0_DEGREES) {
+        this->filled_rectangle(x, y, w, h, color);
+        return;
+    }
+    // Clip once to the framebuffer.
+    const int x0 = std::max(x, 0);
+    const int y0 = std::max(y, 0);
+    const int x1 = std::min(x + w, this->cached_width_);
+    const int y1 = std::min(y + h, this->cached_height_);
+    if (x0 >= x1 || y0 >= y1)
+        return;
+    for (int row = y0; row < y1; ++row) {
+        for (int x = x0; x < x1;) {
+            const int end = this->span_end_(x, x1);
+            this->fill_span_(this->pixel_index_(x, row), end - x, color);
+            x = end;
+        }
+    }
+    if (this->content_diff_ != ContentDiffMode::NONE || this->render_task_ ||
+        this->pending_fill_count_ == kMaxPendingFills) {
+        this->mark_rect_dirty_(x0, y0, x1 - x0, y1 - y0);
+        return;
+    }
+    this->record_fill_(x0, y0, x1 - x0, y1 - y0, color);
+}
+
+void MatrixDisplay::draw_pixels_at(int x_start, int y_start, int w, int h,
+                                   const uint8_t *ptr,
+                                   display::ColorOrder order,
+                                   display::ColorBitness bitness,
+                                   bool big_endian, int x_offset, int y_offset,
+                                   int x_pad) {
+    if (this->foreign_draw_("draw_pixels_at"))
+        return;
+    if (this->buffer_ == nullptr || this->is_clipping() ||
+        this->get_rotation() != display::DISPLAY_ROTATION_0_DEGREES ||
+        (bitness != display::COLOR_BITNESS_888 &&
+         bitness != display::COLOR_BITNESS_565)) {
+        display::DisplayBuffer::draw_pixels_at(x_start, y_start, w, h, ptr,
+                                               order, bitness, big_endian,
+                                               x_offset, y_offset, x_pad);
+        return;
+    }
+    // Clip once against the framebuffer, shifting the source window along.
+    const int x0 = std::max(x_start, 0);
+    const int y0 = std::max(y_start, 0);
+    const int x1 = std::min(x_start + w, this->cached_width_);
+    const int y1 = std::min(y_start + h, this->cached_height_);
+    if (x0 >= x1 || y0 >= y1)
+        return;
+    const size_t line_stride = static_cast<size_t>(x_offset) + w + x_pad;
+    const size_t src_bpp = bitness == display::COLOR_BITNESS_888 ? 3 : 2;
+    const int span = x1 - x0;
+    // Sources laid out exactly like the framebuffer are copied row by row.
+    const bool direct =
+        order == display::COLOR_ORDER_RGB &&
+        ((bitness == display::COLOR_BITNESS_888 && big_endian &&
+          this->pixel_format_ == PixelFormat::RGB888) ||
+         (bitness == display::COLOR_BITNESS_565 && !big_endian &&
+          this->pixel_format_ == PixelFormat::RGB565));
+    for (int y = y0; y < y1; ++y) {
+        const size_t src_index = (static_cast<size_t>(y_offset) + y - y_start) *
+                                     line_stride +
+                                 x_offset + (x0 - x_start);
+        const uint8_t *src = ptr + src_index * src_bpp;
+        // One segment per row, or one per chunk with a tiled framebuffer.
+        for (int x = x0; x < x1;) {
+            const int end = this->span_end_(x, x1);
+            const size_t dst_index = this->pixel_index_(x, y);
+            const int pixels = end - x;
+            x = end;
+            if (direct) {
+                std::memcpy(this->buffer_ + this->fb_bytes_(dst_index), src,
+                            static_cast<size_t>(pixels) * src_bpp);
+                src += static_cast<size_t>(pixels) * src_bpp;
+                continue;
+            }
+            for (int i = 0; i < pixels; ++i, src += src_bpp) {
+                uint32_t value;
+                if (src_bpp == 3) {
+                    value = big_endian
+                                ? (src[0] << 16) | (src[1] << 8) | src[2]
+                                : src[0] | (src[1] << 8) | (src[2] << 16);
+                } else {
+                    value = big_endian ? (src[0] << 8) | src[1]
+                                       : src[0] | (src[1] << 8);
+                }
+                this->store_pixel_(
+                    dst_index + i,
+                    display::ColorUtil::to_color(value, order, bitness));
+            }
+        }
+    }
+    this->mark_rect_dirty_(x0, y0, span, y1 - y0);
+}
+
+bool MatrixDisplay::cache_asset(uint16_t id, int w, int h, const uint8_t *ptr,
+                                display::ColorOrder order,
+                                display::ColorBitness bitness,
+                                bool big_endian) {
+    if (this->foreign_draw_("cache_asset"))
+        return false;
+    if (w <= 0 || h <= 0 || w > INT16_MAX || h > INT16_MAX ||
+        (bitness != display::COLOR_BITNESS_888 &&
+         bitness != display::COLOR_BITNESS_565))
+        return false;
+    // RGB444 rows hold whole pixel pairs, so round the last one up.
+    const size_t pixels = static_cast<size_t>(w) * h;
+    const size_t bytes = this->fb_bytes_((pixels + 1) & ~static_cast<size_t>(1));
+    if (bytes > this->asset_cache_bytes_)
+        return false;
+    // Convert into a fresh block first: if that fails, the cache, including
+    // any asset under the same id, stays as it was.
+    bool psram;
+    uint8_t *data = this->alloc_frame_(bytes, false, psram);
+    if (data == nullptr)
+        return false;
+    const size_t src_bpp = bitness == display::COLOR_BITNESS_888 ? 3 : 2;
+    for (size_t i = 0; i < pixels; ++i, ptr += src_bpp) {
+        uint32_t value;
+        if (src_bpp == 3) {
+            value = big_endian ? (ptr[0] << 16) | (ptr[1] << 8) | ptr[2]
+                               : ptr[0] | (ptr[1] << 8) | (ptr[2] << 16);
+        } else {
+            value = big_endian ? (ptr[0] << 8) | ptr[1] : ptr[0] | (ptr[1] << 8);
+        }
+        this->store_pixel_to_(
+            data, i, display::ColorUtil::to_color(value, order, bitness));
+    }
+    for (size_t slot = 0; slot < this->assets_.size(); ++slot) {
+        if (this->assets_[slot].id == id) {
+            this->evict_asset_(slot);
+            break;
+        }
+    }
+    while (this->asset_bytes_used_ + bytes > this->asset_cache_bytes_) {
+        size_t oldest = 0;
+        for (size_t slot = 1; slot < this->assets_.size(); ++slot) {
+            if (this->assets_[slot].last_used < this->assets_[oldest].last_used)
+                oldest = slot;
+        }
+        ESP_LOGD(TAG, "Evicting asset %u", this->assets_[oldest].id);
+        this->evict_asset_(oldest);
+    }
+    // Caching counts as a use, so the new asset outlives everything drawn
+    // before it.
+    this->assets_.push_back({id, static_cast<int16_t>(w),
+                             static_cast<int16_t>(h), ++this->asset_clock_,
+                             bytes, data});
+    this->asset_bytes_used_ += bytes;
+    return true;
+}
+
+bool MatrixDisplay::foreign_draw_(const char *call) {
+    if (this->render_task_handle_ == nullptr ||
+        xTaskGetCurrentTaskHandle() == this->render_task_handle_)
+        return false;
+    if (!this->foreign_draw_warned_) {
+        ESP_LOGW(TAG, "%s() outside the display lambda ignored: the render "
+                      "task owns the framebuffer",
+                 call);
+        this->foreign_draw_warned_ = true;
+    }
+    return true;
+}
+
+void MatrixDisplay::evict_asset_(size_t slot) {
+    this->asset_bytes_used_ -= this->assets_[slot].bytes;
+    heap_caps_free(this->assets_[slot].data);
+    this->assets_[slot] = this->assets_.back();
+    this->assets_.pop_back();
+}
+
+bool MatrixDisplay::draw_asset(uint16_t id, int x, int y) {
+    if (this->foreign_draw_("draw_asset"))
+        return false;
+    Asset *asset = nullptr;
+    for (Asset &candidate : this->assets_) {
+        if (candidate.id == id) {
+            asset = &candidate;
+            break;
+        }
+    }
+    if (asset == nullptr) {
+        this->asset_misses_++;
+        return false;
+    }
+    this->asset_hits_++;
+    asset->last_used = ++this->asset_clock_;
+    if (this->buffer_ == nullptr)
+        return true;
+    // Row copies need the asset's rows to line up with the framebuffer's
+    // storage units; anything else goes through the per-pixel path.
+    const bool pairs_aligned = this->pixel_format_ != PixelFormat::RGB444 ||
+                               ((x | asset->w) & 1) == 0;
+    if (this->is_clipping() || !pairs_aligned ||
+        this->get_rotation() != display::DISPLAY_ROTATION_0_DEGREES) {
+        for (int row = 0; row < asset->h; ++row) {
+            for (int col = 0; col < asset->w; ++col) {
+                this->draw_pixel_at(
+                    x + col, y + row,
+                    this->load_pixel_(asset->data,
+                                      static_cast<size_t>(row) * asset->w + col));
+            }
+        }
+        return true;
+    }
+    const int x0 = std::max(x, 0);
+    const int y0 = std::max(y, 0);
+    const int x1 = std::min(x + asset->w, this->cached_width_);
+    const int y1 = std::min(y + asset->h, this->cached_height_);
+    for (int row = y0; row < y1; ++row) {
+        for (int col = x0; col < x1;) {
+            const int end = this->span_end_(col, x1);
+            const size_t bytes = this->fb_bytes_(static_cast<size_t>(end - col));
+            const uint8_t *src =
+                asset->data +
+                this->fb_bytes_(static_cast<size_t>(row - y) * asset->w +
+                                (col - x));
+            uint8_t *dst = this->buffer_ + this->fb_bytes_(this->pixel_index_(col, row));
+            // Only segments that actually change are written and marked.
+            if (std::memcmp(dst, src, bytes) != 0) {
+                std::memcpy(dst, src, bytes);
+                this->mark_rect_dirty_(col, row, end - col, 1);
+            }
+            col = end;
+        }
+    }
+    return true;
+}
+
+bool MatrixDisplay::scroll_region(int x, int y, int w, int h, int dx, int dy,
+                                  Color fill) {
+    // The render task draws into a slot that does not hold the last frame,
+    // so there is nothing valid to shift.
+    if (this->buffer_ == nullptr || this->render_task_ || this->is_clipping() ||
+        this->get_rotation() != display::DISPLAY_ROTATION_0_DEGREES)
+        return false;
+    const int x0 = std::max(x, 0);
+    const int y0 = std::max(y, 0);
+    const int x1 = std::min(x + w, this->cached_width_);
+    const int y1 = std::min(y + h, this->cached_height_);
+    if (x0 >= x1 || y0 >= y1)
+        return true;
+    if (dx >= x1 - x0 || -dx >= x1 - x0 || dy >= y1 - y0 || -dy >= y1 - y0) {
+        this->fill_rect(x0, y0, x1 - x0, y1 - y0, fill);
+        return true;
+    }
+    // Destination of the shifted pixels; the rest of the region is exposed.
+    const int dst_x0 = x0 + std::max(dx, 0);
+    const int dst_x1 = x1 + std::min(dx, 0);
+    const int dst_y0 = y0 + std::max(dy, 0);
+    const int dst_y1 = y1 + std::min(dy, 0);
+    const int span = dst_x1 - dst_x0;
+    // RGB444 pairs can only be moved as bytes when no pair is split.
+    const bool bytewise = this->pixel_format_ != PixelFormat::RGB444 ||
+                          ((dst_x0 | dx | span) & 1) == 0;
+    const size_t row_bytes = this->fb_bytes_(static_cast<size_t>(span));
+    if (bytewise && this->scroll_row_.size() < row_bytes)
+        this->scroll_row_.resize(row_bytes);
+    for (int i = 0; i < dst_y1 - dst_y0; ++i) {
+        // Walk away from the source so no row is overwritten before it moves.
+        const int row = dy > 0 ? dst_y1 - 1 - i : dst_y0 + i;
+        if (!bytewise) {
+            for (int j = 0; j < span; ++j) {
+                const int col = dx > 0 ? dst_x1 - 1 - j : dst_x0 + j;
+                this->store_pixel_(
+                    this->pixel_index_(col, row),
+                    this->load_pixel_(this->buffer_,
+                                      this->pixel_index_(col - dx, row - dy)));
+            }
+            this->mark_rect_dirty_(dst_x0, row, span, 1);
+            continue;
+        }
+        // Gather the source row first, so overlapping moves and chunk edges
+        // of a tiled framebuffer need no special ordering.
+        uint8_t *row_copy = this->scroll_row_.data();
+        for (int col = dst_x0 - dx; col < dst_x1 - dx;) {
+            const int end = this->span_end_(col, dst_x1 - dx);
+            std::memcpy(row_copy + this->fb_bytes_(static_cast<size_t>(
+                                       col - (dst_x0 - dx))),
+                        this->buffer_ +
+                            this->fb_bytes_(this->pixel_index_(col, row - dy)),
+                        this->fb_bytes_(static_cast<size_t>(end - col)));
+            col = end;
+        }
+        for (int col = dst_x0; col < dst_x1;) {
+            const int end = this->span_end_(col, dst_x1);
+            const size_t bytes = this->fb_bytes_(static_cast<size_t>(end - col));
+            const uint8_t *src =
+                row_copy + this->fb_bytes_(static_cast<size_t>(col - dst_x0));
+            uint8_t *dst =
+                this->buffer_ + this->fb_bytes_(this->pixel_index_(col, row));
+            // Rows the shift leaves as they were (blank background) stay
+            // clean, whatever the content_diff mode.
+            if (std::memcmp(dst, src, bytes) != 0) {
+                std::memcpy(dst, src, bytes);
+                this->mark_rect_dirty_(col, row, end - col, 1);
+            }
+            col = end;
+        }
+    }
+    // The exposed strips; the corner both share is filled twice.
+    if (dx != 0)
+        this->fill_rect(dx > 0 ? x0 : dst_x1, y0, dx > 0 ? dx : -dx, y1 - y0,
+                        fill);
+    if (dy != 0)
+        this->fill_rect(x0, dy > 0 ? y0 : dst_y1, x1 - x0, dy > 0 ? dy : -dy,
+                        fill);
+    return true;
+}
+
+void MatrixDisplay::record_fill_(int x, int y, int w, int h, Color color) {
+    // Send the colour as the framebuffer stores it, so filled pixels match
+    // pixels of the same colour that reach the FPGA as rect uploads.
+    uint8_t px[3];
+    this->expand_pixel_(px, this->buffer_, this->pixel_index_(x, y));
+    this->pending_fills_[this->pending_fill_count_++] = {
+        static_cast<int16_t>(x), static_cast<int16_t>(y),
+        static_cast<int16_t>(w), static_cast<int16_t>(h),
+        px[0], px[1], px[2]};
+    this->dirty_any_ = true;
+}
+
+bool MatrixDisplay::replay_fills_(uint32_t deadline) {
+    const bool budgeted = this->flush_budget_us_ != 0;
+    const uint32_t replay_start = micros();
+    // At least one fill goes out per call so the replay always advances.
+    while (this->replay_cursor_ < this->pending_fill_count_) {
+        const FillPrimitive &fill = this->pending_fills_[this->replay_cursor_++];
+        this->flush_any_sent_ = true;
+        if (fill.w == this->cached_width_ && fill.h == this->cached_height_) {
+            this->dma_display_->fillScreenRGB888(fill.r, fill.g, fill.b);
+            this->note_command_(3);
+        } else {
+            // A solid rect stays a solid rect on every panel it covers.
+            this->layout_.split(fill.x, fill.y, fill.w, fill.h, this->pieces_);
+            for (const PanelLayout::Piece &piece : this->pieces_) {
+                this->dma_display_->fillRect(piece.chain_x, piece.chain_y,
+                                             piece.chain_w, piece.chain_h,
+                                             fill.r, fill.g, fill.b);
+                this->note_command_(3);
+            }
+        }
+        if (budgeted && static_cast<int32_t>(micros() - deadline) >= 0)
+            break;
+    }
+    this->add_phase_micros_(LatencyPhase::TRANSFER, micros() - replay_start);
+    if (this->replay_cursor_ < this->pending_fill_count_)
+        return false;
+    this->pending_fill_count_ = 0;
+    this->replay_cursor_ = 0;
+    return true;
+}
+
+bool MatrixDisplay::diff_chunks_(uint32_t deadline) {
+    const bool budgeted = this->flush_budget_us_ != 0;
+    const uint32_t diff_start = micros();
+    // flush_cursor_ walks the chunks here, then restarts for the sends.
+    while (this->flush_cursor_ < this->chunk_count_) {
+        const int chunk = this->flush_cursor_++;
+        ChunkDirty &dirty = this->dirty_chunks_[static_cast<size_t>(chunk)];
+        if (!dirty.is_dirty())
+            continue;
+        this->diff_chunk_(chunk, dirty);
+        if (budgeted && static_cast<int32_t>(micros() - deadline) >= 0)
+            break;
+    }
+    this->add_phase_micros_(LatencyPhase::PACK, micros() - diff_start);
+    if (this->flush_cursor_ < this->chunk_count_)
+        return false;
+    this->flush_cursor_ = 0;
+    return true;
+}
+
 void HOT MatrixDisplay::swap() { this->dma_display_->swapFrame(); }
+
+void MatrixDisplay::configure_chunks_(int width) {
+    this->chunk_shift_ = 0;
+    while ((1 << (this->chunk_shift_ + 1)) <= width)
+        this->chunk_shift_++;
+    this->chunk_width_ = 1 << this->chunk_shift_;
+    this->chunk_count_ = (this->cached_width_ + this->chunk_width_ - 1) >>
+                         this->chunk_shift_;
+    this->dirty_chunks_.assign(this->chunk_count_, ChunkDirty{});
+    if (!this->row_hashes_.empty()) {
+        this->row_hashes_.assign(
+            static_cast<size_t>(this->chunk_count_) * this->cached_height_, 0);
+    }
+}
+
+int MatrixDisplay::auto_chunk_width_() const {
+    const size_t ratio = this->tiled_ ? kTiledChunkOverheadRatio
+                                      : kRowChunkOverheadRatio;
+    const size_t min_bytes = ratio * this->command_overhead_bytes_;
+    const size_t column_bytes = static_cast<size_t>(this->cached_height_) * 3;
+    int max_width = std::min(kMaxChunkWidth, this->cached_width_);
+    if (!this->layout_.is_identity())
+        max_width = std::min<int>(max_width, this->mxconfig_.mx_width);
+    if (!this->tiled_) {
+        max_width = std::min(
+            max_width, static_cast<int>(this->chunk_buffer_bytes_ /
+                                        column_bytes));
+    }
+    int width = kMinChunkWidth;
+    while (width * 2 <= max_width && width * column_bytes < min_bytes)
+        width <<= 1;
+    return width;
+}
+
+bool MatrixDisplay::measure_command_cost_() {
+    // Any DMA-capable buffer will do; what it holds does not matter.
+    uint8_t *payload =
+        !this->chunk_buffers_.empty() ? this->chunk_buffers_[0]
+        : this->tiled_ ? const_cast<uint8_t *>(this->flush_buffer_)
+                       : nullptr;
+    if (payload == nullptr || !this->dma_display_->worker_is_idle())
+        return false;
+    const int chain_width =
+        this->mxconfig_.mx_width * this->mxconfig_.chain_length;
+    const int h = this->mxconfig_.mx_height;
+    const int w = static_cast<int>(std::min<size_t>(
+        chain_width, this->chunk_buffer_bytes_ / (static_cast<size_t>(h) * 3)));
+    const size_t bytes = static_cast<size_t>(w) * h * 3;
+    if (w <= 0 || bytes <= 3)
+        return false;
+    this->dma_display_->enable_worker(false);
+    uint32_t start = micros();
+    for (int i = 0; i < kCostProbeCommands; ++i)
+        this->dma_display_->drawRectRGB888_prealloc(0, 0, 1, 1, payload, 3);
+    const uint32_t small = micros() - start;
+    start = micros();
+    this->dma_display_->drawRectRGB888_prealloc(0, 0, w, h, payload, bytes);
+    const uint32_t large = micros() - start;
+    this->dma_display_->enable_worker(true);
+    // The small rects took n * (c + 3b) and the large one c + bytes * b,
+    // for a fixed cost c and a per-byte cost b; solve for c / b.
+    const int64_t denominator =
+        static_cast<int64_t>(large) * kCostProbeCommands - small;
+    if (denominator <= 0) {
+        ESP_LOGW(TAG, "Command cost measurement inconclusive; assuming %u "
+                      "bytes",
+                 static_cast<unsigned>(this->command_overhead_bytes_));
+        return false;
+    }
+    const int64_t overhead =
+        static_cast<int64_t>(small) * static_cast<int64_t>(bytes - 3) /
+            denominator -
+        3;
+    this->command_overhead_bytes_ = static_cast<size_t>(
+        clamp<int64_t>(overhead, kRectHeaderBytes, static_cast<int64_t>(bytes)));
+    ESP_LOGD(TAG, "Command overhead: %u bytes at %u MHz",
+             static_cast<unsigned>(this->command_overhead_bytes_),
+             static_cast<unsigned>(this->mxconfig_.spispeed / 1000000));
+    // The probe rects count into the FPGA's payload sum.
+    this->integrity_resync_ = true;
+    return true;
+}
+
+uint8_t *MatrixDisplay::alloc_frame_(size_t bytes, bool dma,
+                                     bool &psram) const {
+    uint8_t *buffer = nullptr;
+    if (dma) {
+        psram = false;
+        buffer = static_cast<uint8_t *>(
+            heap_caps_malloc(bytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL));
+        if (buffer != nullptr)
+            std::memset(buffer, 0, bytes);
+        return buffer;
+    }
+    if (this->framebuffer_location_ != BufferLocation::INTERNAL) {
+        buffer = static_cast<uint8_t *>(
+            heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+    }
+    psram = buffer != nullptr;
+    if (buffer == nullptr &&
+        this->framebuffer_location_ != BufferLocation::PSRAM) {
+        buffer = static_cast<uint8_t *>(
+            heap_caps_malloc(bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT));
+    }
+    if (buffer != nullptr)
+        std::memset(buffer, 0, bytes);
+    return buffer;
+}
+
+void MatrixDisplay::expand_pixel_(uint8_t *dst, const uint8_t *fb,
+                                  size_t index) const {
+    // RGB444 stores pixel pairs, so expand the whole pair and pick one.
+    const size_t unit = this->pixel_format_ == PixelFormat::RGB444 ? index & ~1
+                                                                   : index;
+    uint8_t rgb[6];
+    this->expand_row_(rgb, fb + this->fb_bytes_(unit),
+                      this->pixel_format_ == PixelFormat::RGB444 ? 2 : 1);
+    std::memcpy(dst, rgb + (index - unit) * 3, 3);
+}
+
+void MatrixDisplay::pack_piece_(uint8_t *dst,
+                                const PanelLayout::Piece &piece) const {
+    const int width = this->cached_width_;
+    const uint8_t *fb = this->flush_buffer_;
+    const size_t row_bytes = static_cast<size_t>(piece.w) * 3;
+    switch (piece.quarter_turns) {
+    case 0:
+        // A full-width band is one contiguous span of the framebuffer, so
+        // it is read in a single sequential pass; from PSRAM that keeps the
+        // cache streaming instead of refilling a line per row.
+        if (piece.w == width) {
+            this->expand_row_(
+                dst, fb + this->fb_bytes_(static_cast<size_t>(piece.y) * width),
+                piece.w * piece.h);
+            break;
+        }
+        for (int y = piece.y; y < piece.y + piece.h; ++y, dst += row_bytes) {
+            this->expand_row_(
+                dst,
+                fb + this->fb_bytes_(static_cast<size_t>(y) * width + piece.x),
+                piece.w);
+        }
+        break;
+    case 2:
+        // Upside down: rows bottom-up, each mirrored.
+        for (int y = piece.y + piece.h - 1; y >= piece.y;
+             --y, dst += row_bytes) {
+            this->expand_row_(
+                dst,
+                fb + this->fb_bytes_(static_cast<size_t>(y) * width + piece.x),
+                piece.w);
+            for (int l = 0, r = piece.w - 1; l < r; ++l, --r)
+                std::swap_ranges(dst + l * 3, dst + l * 3 + 3, dst + r * 3);
+        }
+        break;
+    default:
+        // Quarter turns: each chain row is a logical column.
+        for (int j = 0; j < piece.chain_h; ++j) {
+            for (int i = 0; i < piece.chain_w; ++i, dst += 3) {
+                const int x = piece.quarter_turns == 1 ? piece.x + piece.w - 1 - j
+                                                       : piece.x + j;
+                const int y = piece.quarter_turns == 1 ? piece.y + i
+                                                       : piece.y + piece.h - 1 - i;
+                this->expand_pixel_(dst, fb,
+                                    static_cast<size_t>(y) * width + x);
+            }
+        }
+        break;
+    }
+}
+
+/// Maps RGB888 bytes through per-channel tables.
+static void map_rgb888(uint8_t *dst, const uint8_t *src, size_t bytes,
+                       const uint8_t (*lut)[256]) {
+    for (size_t i = 0; i < bytes; i += 3) {
+        dst[i] = lut[0][src[i]];
+        dst[i + 1] = lut[1][src[i + 1]];
+        dst[i + 2] = lut[2][src[i + 2]];
+    }
+}
+
+void MatrixDisplay::expand_row_(uint8_t *dst, const uint8_t *src,
+                                int pixels) const {
+    // Correction rides along in the same pass; without it RGB888 stays a
+    // plain memcpy.
+    const uint8_t(*lut)[256] =
+        this->color_lut_active_ ? this->color_lut_ : nullptr;
+    switch (this->pixel_format_) {
+    case PixelFormat::RGB888:
+        if (lut == nullptr)
+            std::memcpy(dst, src, static_cast<size_t>(pixels) * 3);
+        else
+            map_rgb888(dst, src, static_cast<size_t>(pixels) * 3, lut);
+        break;
+    case PixelFormat::RGB565:
+        for (int i = 0; i < pixels; ++i, src += 2, dst += 3) {
+            const uint16_t v = src[0] | (src[1] << 8);
+            const uint8_t r = (v >> 11) & 0x1F;
+            const uint8_t g = (v >> 5) & 0x3F;
+            const uint8_t b = v & 0x1F;
+            // Replicate the high bits so full scale stays full scale.
+            dst[0] = (r << 3) | (r >> 2);
+            dst[1] = (g << 2) | (g >> 4);
+            dst[2] = (b << 3) | (b >> 2);
+            if (lut != nullptr) {
+                dst[0] = lut[0][dst[0]];
+                dst[1] = lut[1][dst[1]];
+                dst[2] = lut[2][dst[2]];
+            }
+        }
+        break;
+    case PixelFormat::RGB444:
+        // Three input bytes hold six nibbles, i.e. two pixels.
+        for (int i = 0; i < pixels; i += 2, src += 3, dst += 6) {
+            dst[0] = (src[0] & 0xF0) | (src[0] >> 4);
+            dst[1] = (src[0] << 4) | (src[0] & 0x0F);
+            dst[2] = (src[1] & 0xF0) | (src[1] >> 4);
+            dst[3] = (src[1] << 4) | (src[1] & 0x0F);
+            dst[4] = (src[2] & 0xF0) | (src[2] >> 4);
+            dst[5] = (src[2] << 4) | (src[2] & 0x0F);
+            if (lut != nullptr) {
+                for (int k = 0; k < 6; ++k)
+                    dst[k] = lut[k % 3][dst[k]];
+            }
+        }
+        break;
+    }
+}
+
+/// FNV-1a over one chunk row; cheap enough to run on every dirty row.
+static uint32_t hash_span(const uint8_t *data, size_t len) {
+    uint32_t hash = 2166136261UL;
+    for (size_t i = 0; i < len; ++i) {
+        hash ^= data[i];
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+bool MatrixDisplay::diff_chunk_(int chunk, ChunkDirty &dirty) {
+    if (this->content_diff_ == ContentDiffMode::NONE)
+        return true;
+    const int width = this->cached_width_;
+    const int x = chunk * this->chunk_width_;
+    const size_t span = this->fb_bytes_(
+        static_cast<size_t>(std::min(this->chunk_width_, width - x)));
+    int first = -1;
+    int last = -1;
+    for (int y = dirty.y_min; y <= dirty.y_max; ++y) {
+        const size_t offset = this->fb_bytes_(this->pixel_index_(x, y));
+        const uint8_t *row = this->flush_buffer_ + offset;
+        bool changed;
+        if (this->content_diff_ == ContentDiffMode::SHADOW) {
+            changed = dirty.force ||
+                      std::memcmp(row, this->shadow_buffer_ + offset, span) != 0;
+            if (changed)
+                std::memcpy(this->shadow_buffer_ + offset, row, span);
+        } else {
+            uint32_t &stored =
+                this->row_hashes_[static_cast<size_t>(chunk) *
+                                      this->cached_height_ +
+                                  y];
+            const uint32_t hash = hash_span(row, span);
+            changed = dirty.force || hash != stored;
+            stored = hash;
+        }
+        if (changed) {
+            if (first < 0)
+                first = y;
+            last = y;
+        }
+    }
+    if (first < 0) {
+        dirty.clear();
+        return false;
+    }
+    dirty.y_min = static_cast<int16_t>(first);
+    dirty.y_max = static_cast<int16_t>(last);
+    dirty.force = false;
+    return true;
+}
+
+/// @brief whether pixels [start, end) of a packed RGB888 row of width @p w
+/// are one run of @p color, with no more of it on either side
+static bool span_repeats(const uint8_t *px, int w, int start, int end,
+                         const uint8_t *color) {
+    if ((start > 0 && std::memcmp(px + (start - 1) * 3, color, 3) == 0) ||
+        (end < w && std::memcmp(px + end * 3, color, 3) == 0))
+        return false;
+    for (int i = start; i < end; ++i) {
+        if (std::memcmp(px + i * 3, color, 3) != 0)
+            return false;
+    }
+    return true;
+}
+
+void MatrixDisplay::send_raw_(int x, int y, int w, int h,
+                              uint8_t *payload) {
+    const size_t bytes = static_cast<size_t>(w) * h * 3;
+    this->dma_display_->drawRectRGB888_prealloc(x, y, w, h, payload, bytes);
+    this->note_command_(bytes);
+    if (this->integrity_addr_ >= 0)
+        this->integrity_expected_ += payload_sum(payload, bytes);
+}
+
+size_t MatrixDisplay::encode_spans_(int x, int y, int w, int h, uint8_t *rgb,
+                                    bool send, bool &raw_sent) {
+    const size_t row_bytes = static_cast<size_t>(w) * 3;
+    const size_t fill_cost = this->rect_cost_(1, 1);
+    SpanFill open[kMaxOpenFills];
+    SpanFill next[kMaxOpenFills];
+    int open_count = 0;
+    // Rows without a fill in them are sent together as one raw band.
+    int band_start = 0;
+    int band_rows = 0;
+    size_t cost = 0;
+    for (int row = 0; row < h; ++row) {
+        uint8_t *px = rgb + row * row_bytes;
+        int next_count = 0;
+        int raw_start = 0;
+        bool row_has_fill = false;
+        for (int i = 0; i < w;) {
+            const uint8_t *color = px + i * 3;
+            int end = i + 1;
+            while (end < w && std::memcmp(px + end * 3, color, 3) == 0)
+                ++end;
+            const int len = end - i;
+            const int start = i;
+            i = end;
+            if (next_count == kMaxOpenFills)
+                continue;
+            // Grow the fill from the row above when the span lines up with
+            // it.
+            SpanFill *above = nullptr;
+            for (int k = 0; k < open_count; ++k) {
+                SpanFill &fill = open[k];
+                if (fill.w == len && fill.x == start && fill.r == color[0] &&
+                    fill.g == color[1] && fill.b == color[2]) {
+                    above = &fill;
+                    break;
+                }
+            }
+            // A new fill has to save more payload, over the rows that repeat
+            // the span, than it costs. Cutting it out of the middle of a raw
+            // row also splits that row in two.
+            if (above == nullptr) {
+                size_t budget = fill_cost;
+                if (start > 0 && end < w)
+                    budget += this->command_overhead_bytes_;
+                const size_t span_bytes = static_cast<size_t>(len) * 3;
+                size_t saved = 0;
+                for (int below = row; below < h && saved <= budget; ++below) {
+                    if (!span_repeats(rgb + below * row_bytes, w, start, end,
+                                      color))
+                        break;
+                    saved += span_bytes;
+                }
+                if (saved <= budget)
+                    continue;
+            }
+            // The first fill in a row ends the raw band above it.
+            if (!row_has_fill) {
+                row_has_fill = true;
+                if (band_rows > 0) {
+                    cost += this->rect_cost_(w, band_rows);
+                    if (send)
+                        this->send_raw_(x, y + band_start, w, band_rows,
+                                        rgb + band_start * row_bytes);
+                    raw_sent = true;
+                    band_rows = 0;
+                }
+            }
+            if (raw_start < start) {
+                cost += this->rect_cost_(start - raw_start, 1);
+                if (send)
+                    this->send_raw_(x + raw_start, y + row, start - raw_start,
+                                    1, px + raw_start * 3);
+                raw_sent = true;
+            }
+            raw_start = end;
+            if (above != nullptr) {
+                next[next_count] = *above;
+                next[next_count++].h++;
+                // Taken: closing the row must not send it.
+                above->w = 0;
+            } else {
+                next[next_count++] = {static_cast<int16_t>(start),
+                                      static_cast<int16_t>(row),
+                                      static_cast<int16_t>(len), 1,
+                                      color[0], color[1], color[2]};
+            }
+        }
+        if (!row_has_fill) {
+            if (band_rows++ == 0)
+                band_start = row;
+        } else if (raw_start < w) {
+            cost += this->rect_cost_(w - raw_start, 1);
+            if (send)
+                this->send_raw_(x + raw_start, y + row, w - raw_start, 1,
+                                px + raw_start * 3);
+            raw_sent = true;
+        }
+        // Fills the row did not continue are complete.
+        for (int k = 0; k < open_count; ++k) {
+            const SpanFill &fill = open[k];
+            if (fill.w == 0)
+                continue;
+            cost += fill_cost;
+            if (send) {
+                this->dma_display_->fillRect(x + fill.x, y + fill.y, fill.w,
+                                             fill.h, fill.r, fill.g, fill.b);
+                this->note_command_(3);
+            }
+        }
+        std::copy(next, next + next_count, open);
+        open_count = next_count;
+    }
+    if (band_rows > 0) {
+        cost += this->rect_cost_(w, band_rows);
+        if (send)
+            this->send_raw_(x, y + band_start, w, band_rows,
+                            rgb + band_start * row_bytes);
+        raw_sent = true;
+    }
+    for (int k = 0; k < open_count; ++k) {
+        const SpanFill &fill = open[k];
+        cost += fill_cost;
+        if (send) {
+            this->dma_display_->fillRect(x + fill.x, y + fill.y, fill.w,
+                                         fill.h, fill.r, fill.g, fill.b);
+            this->note_command_(3);
+        }
+    }
+    return cost;
+}
+
+bool MatrixDisplay::send_as_fills_(int x, int y, int w, int h, uint8_t *rgb,
+                                   bool &raw_sent) {
+    // Plan first, and only send the mixed encoding when it takes less link
+    // time than the raw rect, counting the measured per-command cost.
+    bool planned_raw = false;
+    if (this->encode_spans_(x, y, w, h, rgb, false, planned_raw) >=
+        this->rect_cost_(w, h))
+        return false;
+    this->encode_spans_(x, y, w, h, rgb, true, raw_sent);
+    return true;
+}
+
+MatrixDisplay::WorkerWait MatrixDisplay::poll_worker_idle_(uint32_t deadline) {
+    if (this->dma_display_->worker_is_idle()) {
+        this->worker_waiting_ = false;
+        return WorkerWait::IDLE;
+    }
+    // The stall timeout counts from the first poll, so a wait split across
+    // several budgeted calls still gives up after worker_idle_timeout_ms_.
+    if (!this->worker_waiting_) {
+        this->worker_waiting_ = true;
+        this->worker_wait_start_ms_ = millis();
+    }
+    const uint32_t wait_start = micros();
+    WorkerWait result = WorkerWait::IDLE;
+    while (!this->dma_display_->worker_is_idle()) {
+        if ((millis() - this->worker_wait_start_ms_) >
+            this->worker_idle_timeout_ms_) {
+            ESP_LOGW(TAG, "SPI worker stalled; deferring flush (FPGA busy?)");
+            this->note_link_error_();
+            result = WorkerWait::STALLED;
+            break;
+        }
+        if (this->flush_budget_us_ != 0 &&
+            static_cast<int32_t>(micros() - deadline) >= 0) {
+            result = WorkerWait::PENDING;
+            break;
+        }
+        vTaskDelay(1);
+    }
+    this->add_phase_micros_(LatencyPhase::WAIT, micros() - wait_start);
+    if (result != WorkerWait::PENDING)
+        this->worker_waiting_ = false;
+    return result;
+}
+
 void MatrixDisplay::write_display_data() {
-    if (this->buffer_ == nullptr || this->chunk_buffer_ == nullptr) {
-        ESP_LOGE("MatrixDisplay:write_display_data",
-                 "buffer_ or chunk_buffer_ not initialized!");
+    this->flush_(micros() + this->flush_budget_us_);
+}
+
+void MatrixDisplay::flush_(uint32_t deadline) {
+    if (this->flush_state_ == FlushState::IDLE && !this->begin_flush_())
         return;
+    this->step_flush_(deadline);
+}
+
+bool MatrixDisplay::begin_flush_() {
+    // buffer_ belongs to the render task when there is one.
+    if (this->flush_buffer_ == nullptr ||
+        (this->chunk_buffers_.empty() && !this->tiled_)) {
+        ESP_LOGE("MatrixDisplay:write_display_data",
+                 "buffer_ or chunk_buffers_ not initialized!");
+        return false;
     }
+    // The slot handed back to the render task must not be one a stalled
+    // worker is still sending from.
+    if (this->render_task_ && !this->tiled_in_use_())
+        this->take_ready_frame_();
     // Fast path: nothing changed since the last flush.
     if (!this->dirty_any_)
-        return;
+        return false;
+
+    this->flush_any_sent_ = false;
+    this->flush_cursor_ = 0;
+    this->in_flight_count_ = 0;
+    this->integrity_retries_ = 0;
+    // Take the FPGA's running sum as the baseline after anything that
+    // leaves it unknown (boot, FPGA reset, stall, failed read).
+    if (this->integrity_addr_ >= 0 && this->integrity_resync_ &&
+        !this->resync_integrity_())
+        return false;
+    // A previous pass may have given up on a stalled worker that still owns
+    // one of the staging buffers; don't repack any of them until it drains.
+    this->flush_need_idle_ = this->dma_display_->is_worker_enabled();
+
+    // Recorded fills go first: every pixel drawn after a fill is marked
+    // dirty, so the rect uploads land on top of them.
+    this->replay_cursor_ = 0;
+    this->flush_state_ = FlushState::REPLAYING;
+    return true;
+}
 
+void MatrixDisplay::step_flush_(uint32_t deadline) {
     const int width = this->cached_width_;
-    const int height = this->cached_height_;
-    // kChunkWidth is a fixed upper bound; edge chunks may be narrower.
-    const int chunk_width = kChunkWidth;
+    // chunk_width_ is an upper bound; edge chunks may be narrower.
+    const int chunk_width = this->chunk_width_;
     const bool worker_enabled = this->dma_display_->is_worker_enabled();
-    // Flush only the chunks marked dirty to reduce SPI traffic.
-    bool any_sent = false;
-    bool all_sent = true;
+    const bool budgeted = this->flush_budget_us_ != 0;
+    // Sent in place, a tiled framebuffer has no staging buffers to recycle;
+    // the group is only capped so the in-flight record stays bounded.
+    const size_t buffer_count = this->tiled_
+                                    ? static_cast<size_t>(kMaxStagingBuffers)
+                                    : this->chunk_buffers_.size();
+
+    // Fill replay and the content diff run under the same deadline as the
+    // sends, so a pass with many of either spreads over several calls.
+    if (this->flush_state_ == FlushState::REPLAYING) {
+        if (!this->replay_fills_(deadline))
+            return;
+        this->flush_state_ = FlushState::DIFFING;
+    }
+    if (this->flush_state_ == FlushState::DIFFING) {
+        // Drop rows that match what the FPGA already holds before runs are
+        // formed, so merging only ever spans real changes.
+        if (this->content_diff_ != ContentDiffMode::NONE &&
+            !this->diff_chunks_(deadline))
+            return;
+        this->flush_state_ = FlushState::SENDING;
+    }
 
-    for (int chunk = 0; chunk < this->chunk_count_; ++chunk) {
-        if (this->dirty_chunks_[static_cast<size_t>(chunk)] == 0)
+    // Flush only the chunks marked dirty to reduce SPI traffic. The scan
+    // starts at flush_start_chunk_ and wraps, so chunks left over from a
+    // stalled pass are sent before the rest of the frame.
+    while (this->flush_state_ == FlushState::SENDING) {
+        if (this->flush_cursor_ >= this->chunk_count_) {
+            this->flush_state_ = FlushState::DRAINING;
+            break;
+        }
+        int chunk =
+            (this->flush_start_chunk_ + this->flush_cursor_) % this->chunk_count_;
+        const ChunkDirty &first = this->dirty_chunks_[static_cast<size_t>(chunk)];
+        if (!first.is_dirty()) {
+            this->flush_cursor_++;
             continue;
-        // Avoid reusing the shared chunk buffer while worker jobs are pending.
-        if (worker_enabled) {
-            // Wait for the worker to finish any in-flight SPI transfer before
-            // repacking the shared chunk buffer.
-            uint32_t wait_start = millis();
-            while (!this->dma_display_->worker_is_idle() &&
-                   (millis() - wait_start) <= this->worker_idle_timeout_ms_) {
-                vTaskDelay(1);
-            }
-            if (!this->dma_display_->worker_is_idle()) {
-                ESP_LOGW(TAG, "SPI worker stalled; deferring flush (FPGA busy?)");
-                all_sent = false;
+        }
+        // Out of time: pick up from this chunk on the next call.
+        if (budgeted && static_cast<int32_t>(micros() - deadline) >= 0)
+            return;
+        // Every staging buffer is queued: wait for the worker to drain them
+        // before packing into one again. With two or more buffers the next
+        // rect is packed while the previous one is still on the wire.
+        if (worker_enabled && (this->flush_need_idle_ ||
+                               this->in_flight_count_ == buffer_count)) {
+            switch (this->poll_worker_idle_(deadline)) {
+            case WorkerWait::PENDING:
+                return;
+            case WorkerWait::STALLED:
+                this->abort_flush_(chunk);
+                return;
+            case WorkerWait::IDLE:
+                this->flush_need_idle_ = false;
+                // A damaged group rewinds the scan to send it again.
+                if (this->verify_group_())
+                    continue;
                 break;
             }
         }
+        // Grow a run of adjacent dirty chunks into one rect while it fits the
+        // staging buffer and costs less than sending the chunks one by one
+        // (the union row band may cover rows neither chunk needs). A run
+        // never crosses into chunks this pass has already scanned.
         const int x = chunk * chunk_width;
-        const int w = std::min(chunk_width, width - x);
-        // Each rect payload is packed row-major: w * height * 3 bytes.
+        int last = chunk;
+        ChunkDirty rows = first;
+        size_t separate_cost = this->rect_cost_(
+            std::min(chunk_width, width - x), rows.y_max - rows.y_min + 1);
+        // Tiled chunks are contiguous only one at a time.
+        while (!this->tiled_ && last + 1 < this->chunk_count_ &&
+               last + 1 != this->flush_start_chunk_) {
+            const ChunkDirty &next =
+                this->dirty_chunks_[static_cast<size_t>(last + 1)];
+            if (!next.is_dirty())
+                break;
+            ChunkDirty merged = rows;
+            merged.mark(next.y_min);
+            merged.mark(next.y_max);
+            const int next_x = (last + 1) * chunk_width;
+            const int merged_w = std::min(next_x + chunk_width, width) - x;
+            const int merged_h = merged.y_max - merged.y_min + 1;
+            if (static_cast<size_t>(merged_w) * merged_h * 3 >
+                this->chunk_buffer_bytes_)
+                break;
+            const size_t next_cost =
+                separate_cost +
+                this->rect_cost_(std::min(chunk_width, width - next_x),
+                                 next.y_max - next.y_min + 1);
+            if (this->rect_cost_(merged_w, merged_h) > next_cost)
+                break;
+            separate_cost = next_cost;
+            rows = merged;
+            ++last;
+        }
+        const int w = std::min((last + 1) * chunk_width, width) - x;
+        // Only the dirty row band of the run is sent.
+        const int y0 = rows.y_min;
+        const int h = rows.y_max - rows.y_min + 1;
+        // The packed payloads take w * h * 3 bytes however the layout splits
+        // the rect.
         const size_t rect_bytes =
-            static_cast<size_t>(w) * static_cast<size_t>(height) * 3;
-        if (rect_bytes > this->chunk_buffer_bytes_) {
-            ESP_LOGE(TAG, "Chunk buffer too small for %dx%d rect", w, height);
-            all_sent = false;
-            break;
+            static_cast<size_t>(w) * static_cast<size_t>(h) * 3;
+        if (!this->tiled_ && rect_bytes > this->chunk_buffer_bytes_) {
+            ESP_LOGE(TAG, "Chunk buffer too small for %dx%d rect", w, h);
+            this->abort_flush_(chunk);
+            return;
         }
-        // Pack row-major data for drawRectRGB888_prealloc.
-        size_t dst = 0;
-        for (int y = 0; y < height; ++y) {
-            const size_t src =
-                (static_cast<size_t>(y) * width + x) * 3;
-            const size_t span = static_cast<size_t>(w) * 3;
-            std::memcpy(this->chunk_buffer_ + dst, this->buffer_ + src, span);
-            dst += span;
-        }
-        // Stream the chunk as a rect write using the preallocated buffer.
-        this->dma_display_->drawRectRGB888_prealloc(
-            x, 0, w, height, this->chunk_buffer_, rect_bytes);
-        if (worker_enabled) {
-            // Ensure the worker has finished consuming the buffer before reuse.
-            uint32_t wait_start = millis();
-            while (!this->dma_display_->worker_is_idle() &&
-                   (millis() - wait_start) <= this->worker_idle_timeout_ms_) {
-                vTaskDelay(1);
+        const uint32_t pack_start = micros();
+        this->layout_.split(x, y0, w, h, this->pieces_);
+        uint8_t *staging;
+        size_t offset = 0;
+        if (this->tiled_) {
+            // The chunk's dirty rows already sit in the framebuffer as one
+            // row-major RGB888 rect: hand them to the worker as they are.
+            staging = const_cast<uint8_t *>(this->flush_buffer_) +
+                      this->fb_bytes_(this->pixel_index_(x, y0));
+        } else {
+            // Pack one row-major RGB888 payload per panel the run covers
+            // (just the run itself on a plain chain), back to back.
+            staging = this->chunk_buffers_[this->next_buffer_];
+            for (const PanelLayout::Piece &piece : this->pieces_) {
+                this->pack_piece_(staging + offset, piece);
+                offset += static_cast<size_t>(piece.w) * piece.h * 3;
             }
-            if (!this->dma_display_->worker_is_idle()) {
-                ESP_LOGW(TAG, "SPI worker stalled; deferring flush (FPGA busy?)");
-                all_sent = false;
-                break;
+        }
+        const uint32_t transfer_start = micros();
+        this->add_phase_micros_(LatencyPhase::PACK, transfer_start - pack_start);
+        bool drawn = false;
+        offset = 0;
+        for (const PanelLayout::Piece &piece : this->pieces_) {
+            uint8_t *payload = staging + offset;
+            const size_t bytes = static_cast<size_t>(piece.w) * piece.h * 3;
+            offset += bytes;
+            // Flat spans go out as fill commands when that is cheaper.
+            if (this->compress_rects_ &&
+                this->send_as_fills_(piece.chain_x, piece.chain_y,
+                                     piece.chain_w, piece.chain_h, payload,
+                                     drawn))
+                continue;
+            // Stream the piece as a rect write using the preallocated buffer.
+            this->send_raw_(piece.chain_x, piece.chain_y, piece.chain_w,
+                            piece.chain_h, payload);
+            drawn = true;
+        }
+        // A run sent entirely as fills leaves the staging buffer free.
+        if (drawn) {
+            this->next_buffer_ = (this->next_buffer_ + 1) % buffer_count;
+            if (worker_enabled || this->integrity_addr_ >= 0)
+                this->in_flight_[this->in_flight_count_++] = {chunk, last, rows};
+        }
+        this->add_phase_micros_(LatencyPhase::TRANSFER,
+                                micros() - transfer_start);
+        // Mark the run clean once handed off; chunks still queued on a
+        // stalled worker are re-marked by abort_flush_().
+        this->flush_cursor_ += last - chunk + 1;
+        for (; chunk <= last; ++chunk)
+            this->dirty_chunks_[static_cast<size_t>(chunk)].clear();
+        // Without the worker the rect is on the FPGA already.
+        if (!worker_enabled)
+            this->verify_group_();
+        this->flush_any_sent_ = true;
+    }
+
+    if (this->flush_state_ != FlushState::DRAINING)
+        return;
+    // Drain before committing so the swap lands after every rect and the
+    // staging buffers are free for the next pass.
+    if (worker_enabled && this->in_flight_count_ > 0) {
+        switch (this->poll_worker_idle_(deadline)) {
+        case WorkerWait::PENDING:
+            return;
+        case WorkerWait::STALLED:
+            this->abort_flush_(this->flush_start_chunk_);
+            return;
+        case WorkerWait::IDLE:
+            // Send a damaged last group again before the swap shows it.
+            if (this->verify_group_()) {
+                this->flush_state_ = FlushState::SENDING;
+                this->step_flush_(deadline);
+                return;
             }
+            break;
         }
-        // Mark the chunk clean only after a successful send.
-        this->dirty_chunks_[static_cast<size_t>(chunk)] = 0;
-        any_sent = true;
     }
+    this->finish_flush_();
+}
 
+void MatrixDisplay::finish_flush_() {
     // Only swap/copy if we issued at least one chunk update.
-    if (any_sent) {
+    if (this->flush_any_sent_) {
         // Commit the staged updates to the visible buffer.
+        const uint32_t swap_start = micros();
         this->dma_display_->swapFrame();
         this->dma_display_->copyFrame();
+        this->note_command_(0);
+        this->note_command_(0);
+        this->flush_stats_.commits++;
+        this->record_phase_(LatencyPhase::SWAP, micros() - swap_start);
     }
+    // The frame is done: its pack, wait and transfer time may have been
+    // spread over several calls.
+    for (LatencyPhase phase :
+         {LatencyPhase::PACK, LatencyPhase::WAIT, LatencyPhase::TRANSFER}) {
+        this->record_phase_(phase,
+                            this->phase_micros_[static_cast<size_t>(phase)]);
+        this->phase_micros_[static_cast<size_t>(phase)] = 0;
+    }
+    this->flush_state_ = FlushState::IDLE;
+    this->flush_start_chunk_ = 0;
+    // Pixels drawn outside the writer while the pass was running may have
+    // dirtied chunks it had already scanned.
+    this->refresh_dirty_any_();
+}
 
-    // Clear the dirty flag only if all pending chunks were flushed.
-    if (all_sent) {
-        this->dirty_any_ = false;
-    } else {
-        // Recompute dirty_any_ based on any remaining dirty chunks.
-        this->dirty_any_ = false;
-        for (int chunk = 0; chunk < this->chunk_count_; ++chunk) {
-            if (this->dirty_chunks_[static_cast<size_t>(chunk)] != 0) {
-                this->dirty_any_ = true;
-                break;
+bool MatrixDisplay::verify_group_() {
+    bool rewind = false;
+    if (this->integrity_addr_ >= 0 && this->in_flight_count_ > 0) {
+        uint64_t reported = 0;
+        if (!this->read_integrity_(reported)) {
+            // Can't tell; trust the group and resync before the next pass.
+            this->log_status_read_failure_();
+            this->integrity_resync_ = true;
+        } else if (static_cast<uint32_t>(reported) !=
+                   this->integrity_expected_) {
+            // Some rect of the group arrived damaged. The worker only
+            // reports the group as a whole, so re-send every chunk in it,
+            // bypassing the content diff, whose reference counts them sent.
+            uint32_t chunks = 0;
+            for (size_t i = 0; i < this->in_flight_count_; ++i) {
+                const InFlight &rect = this->in_flight_[i];
+                for (int c = rect.first_chunk; c <= rect.last_chunk; ++c) {
+                    ChunkDirty &dirty = this->dirty_chunks_[static_cast<size_t>(c)];
+                    dirty.mark(rect.rows.y_min);
+                    dirty.mark(rect.rows.y_max);
+                    dirty.force = true;
+                    chunks++;
+                }
+            }
+            ESP_LOGD(TAG, "Integrity mismatch (sent %08X, FPGA %08X); "
+                          "re-sending %u chunks",
+                     static_cast<unsigned>(this->integrity_expected_),
+                     static_cast<unsigned>(reported),
+                     static_cast<unsigned>(chunks));
+            this->flush_stats_.corrupt_chunks += chunks;
+            this->integrity_expected_ = static_cast<uint32_t>(reported);
+            this->dirty_any_ = true;
+            // Rescan the pass from its start: only the re-marked chunks and
+            // any drawn since are dirty behind the cursor.
+            if (this->integrity_retries_ < kMaxIntegrityRetries) {
+                this->integrity_retries_++;
+                this->flush_cursor_ = 0;
+                rewind = true;
+            } else {
+                ESP_LOGW(TAG, "Integrity retries exhausted; committing the "
+                              "frame and re-sending on the next pass");
             }
         }
     }
-};
+    this->in_flight_count_ = 0;
+    return rewind;
+}
+
+bool MatrixDisplay::read_integrity_(uint64_t &value) {
+    // The status poller shares the status SPI.
+    xSemaphoreTake(this->panel_mutex_, portMAX_DELAY);
+    const bool ok = this->dma_display_->readStatus(
+        static_cast<uint8_t>(this->integrity_addr_), value);
+    xSemaphoreGive(this->panel_mutex_);
+    return ok;
+}
+
+bool MatrixDisplay::resync_integrity_() {
+    uint64_t reported = 0;
+    if (!this->read_integrity_(reported)) {
+        this->log_status_read_failure_();
+        return false;
+    }
+    this->integrity_expected_ = static_cast<uint32_t>(reported);
+    this->integrity_resync_ = false;
+    return true;
+}
+
+void MatrixDisplay::abort_flush_(int chunk) {
+    // Delivery of the queued rects is unknown; send them again, first.
+    for (size_t i = 0; i < this->in_flight_count_; ++i) {
+        for (int c = this->in_flight_[i].first_chunk;
+             c <= this->in_flight_[i].last_chunk; ++c) {
+            ChunkDirty &dirty = this->dirty_chunks_[static_cast<size_t>(c)];
+            dirty.mark(this->in_flight_[i].rows.y_min);
+            dirty.mark(this->in_flight_[i].rows.y_max);
+        }
+    }
+    this->flush_start_chunk_ = this->in_flight_count_ > 0
+                                   ? this->in_flight_[0].first_chunk
+                                   : chunk;
+    this->in_flight_count_ = 0;
+    // How much of the group reached the FPGA is unknown.
+    this->integrity_resync_ = true;
+    if (this->content_diff_ != ContentDiffMode::NONE) {
+        // The diff reference already counts every remaining dirty row as
+        // sent, so those rows must go out without diffing next time.
+        for (ChunkDirty &dirty : this->dirty_chunks_) {
+            if (dirty.is_dirty())
+                dirty.force = true;
+        }
+    }
+    // A tiled framebuffer is the worker's DMA source; hold off drawing into
+    // it until the stalled transfers are done.
+    this->tiled_hold_ =
+        this->tiled_ && this->dma_display_->is_worker_enabled();
+    // The frame is not committed: the back buffer keeps what was sent and
+    // the next pass completes it before swapping.
+    this->flush_state_ = FlushState::IDLE;
+    this->refresh_dirty_any_();
+}
+
+bool MatrixDisplay::tiled_in_use_() {
+    if (!this->tiled_hold_)
+        return false;
+    if (!this->dma_display_->worker_is_idle())
+        return true;
+    this->tiled_hold_ = false;
+    return false;
+}
+
+void MatrixDisplay::render_task_fn_(void *arg) {
+    auto *self = static_cast<MatrixDisplay *>(arg);
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        self->render_frame_();
+    }
+}
+
+void MatrixDisplay::render_frame_() {
+    const uint32_t render_start = micros();
+    this->do_update_();
+    this->render_micros_.store(micros() - render_start);
+    // Publish the frame and draw the next one into the slot it replaces,
+    // which the flush is not using.
+    const uint8_t published = this->draw_slot_;
+    const uint8_t previous =
+        this->ready_slot_.exchange(static_cast<uint8_t>(published | kSlotFresh));
+    if ((previous & kSlotFresh) != 0)
+        this->dropped_frames_++;
+    this->draw_slot_ = previous & kSlotIndex;
+    this->buffer_ = this->frames_[this->draw_slot_];
+    // Writers that don't clear draw on top of the frame they just finished.
+    if (!this->auto_clear_enabled_) {
+        std::memcpy(this->buffer_, this->frames_[published],
+                    this->fb_bytes_(static_cast<size_t>(this->cached_width_) *
+                                    this->cached_height_));
+    }
+}
+
+bool MatrixDisplay::take_ready_frame_() {
+    if ((this->ready_slot_.load() & kSlotFresh) == 0)
+        return false;
+    const uint8_t taken = this->ready_slot_.exchange(this->flush_slot_);
+    this->flush_slot_ = taken & kSlotIndex;
+    this->flush_buffer_ = this->frames_[this->flush_slot_];
+    // The render task can't touch the histograms; its timing of the frame
+    // is recorded here, where the frame is taken.
+    this->record_phase_(LatencyPhase::RENDER, this->render_micros_.load());
+    // Which rows changed since the last frame is not tracked across slots;
+    // every row is offered and the content diff keeps only real changes.
+    for (ChunkDirty &dirty : this->dirty_chunks_) {
+        dirty.mark(0);
+        dirty.mark(this->cached_height_ - 1);
+    }
+    this->dirty_any_ = true;
+    return true;
+}
+
+void MatrixDisplay::refresh_dirty_any_() {
+    // A fill recorded after this pass replayed its own still needs a pass.
+    this->dirty_any_ = this->pending_fill_count_ > 0;
+    if (this->dirty_any_)
+        return;
+    for (int c = 0; c < this->chunk_count_; ++c) {
+        if (this->dirty_chunks_[static_cast<size_t>(c)].is_dirty()) {
+            this->dirty_any_ = true;
+            break;
+        }
+    }
+}
 
 } // namespace matrix_display
 } // namespace esphome
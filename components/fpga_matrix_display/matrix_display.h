@@ -3,16 +3,27 @@
 // SPDX-License-Identifier: GPL-3.0-only
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <utility>
 #include <vector>
 
 #include "esphome/components/display/display_buffer.h"
 #include "esphome/core/component.h"
 #include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
 #include "esphome/core/log.h"
+#include "esphome/core/preferences.h"
 #include <esp_timer.h>
 
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+#include "latency_histogram.h"
 #include "matrix_panel_fpga.hpp"
+#include "panel_layout.h"
 
 namespace esphome {
 namespace matrix_display {
@@ -28,6 +39,63 @@ static void set_reference(MatrixDisplayBrightness *brightness,
                           MatrixDisplay *display);
 } // namespace matrix_display_brightness
 
+/// How a flush decides whether a written chunk actually changed.
+enum class ContentDiffMode : uint8_t {
+    /// Every chunk touched by a draw call is sent.
+    NONE,
+    /// Compare against a full copy of what the FPGA holds (framebuffer size).
+    SHADOW,
+    /// Compare per-row hashes of each chunk (4 bytes per chunk row).
+    HASH,
+};
+
+/// Storage format of the framebuffer. The panel protocol only takes RGB888
+/// rects, so reduced formats are expanded to 888 while a chunk is packed.
+enum class PixelFormat : uint8_t {
+    /// 3 bytes per pixel, R, G, B.
+    RGB888,
+    /// 2 bytes per pixel, little-endian 5:6:5.
+    RGB565,
+    /// 3 bytes per pixel pair: R0G0 B0R1 G1B1 nibbles. Needs an even width.
+    RGB444,
+};
+
+/// Power state driven by the power switches.
+enum class PowerState : uint8_t {
+    /// Rendering and flushing.
+    ON,
+    /// Switched off; finishing the pass in flight before the panel is
+    /// cleared once.
+    BLANKING,
+    /// Panel cleared; nothing is rendered or sent until switched back on.
+    OFF,
+};
+
+/// Memory the framebuffer, shadow copy and render slots are allocated from.
+/// Staging buffers always stay in internal DMA-capable RAM.
+enum class BufferLocation : uint8_t {
+    /// PSRAM when the board has it, internal RAM otherwise.
+    AUTO,
+    /// Internal RAM only: fastest to pack from, but limits the chain length.
+    INTERNAL,
+    /// PSRAM only; setup fails rather than fall back to internal RAM.
+    PSRAM,
+};
+
+/// Phases of a frame timed into the latency histograms.
+enum class LatencyPhase : uint8_t {
+    /// The writer lambda (on the render task when that is enabled).
+    RENDER,
+    /// Content diff and packing rows into the staging buffers.
+    PACK,
+    /// Waiting for the SPI worker to drain.
+    WAIT,
+    /// Inside the library's rect and fill calls.
+    TRANSFER,
+    /// swapFrame() and copyFrame().
+    SWAP,
+};
+
 class MatrixDisplay : public display::DisplayBuffer {
   public:
     void setup() override;
@@ -36,6 +104,8 @@ class MatrixDisplay : public display::DisplayBuffer {
 
     void update() override;
 
+    void loop() override;
+
     /**
      * Registers a power switch on this matrix entity.
      *
@@ -85,6 +155,22 @@ class MatrixDisplay : public display::DisplayBuffer {
         this->mxconfig_.chain_length = chain_length;
     }
 
+    /**
+     * Arranges the chained panels as a grid instead of one horizontal row.
+     * The chain starts at the top-left panel and runs row by row.
+     *
+     * @param rows panel rows; chain_length must be a multiple of it
+     * @param serpentine odd rows are wired right to left
+     * @param quarter_turns clockwise mounting rotation of each panel in
+     * chain order, in quarter turns; 1 and 3 need square panels
+     */
+    void set_layout(int rows, bool serpentine,
+                    const std::vector<uint8_t> &quarter_turns) {
+        this->layout_rows_ = rows;
+        this->layout_serpentine_ = serpentine;
+        this->layout_turns_ = quarter_turns;
+    }
+
     /**
      * Sets the initial brightness of the display.
      *
@@ -104,6 +190,16 @@ class MatrixDisplay : public display::DisplayBuffer {
         this->use_watchdog = use_watchdog;
     };
 
+    /**
+     * Stops feeding the FPGA watchdog while the display is off, so a dark
+     * display costs no SPI traffic at all.
+     *
+     * @param suspend true to pause the watchdog feed while off
+     */
+    void set_suspend_watchdog_when_off(bool suspend) {
+        this->suspend_watchdog_when_off_ = suspend;
+    };
+
     /**
      * Sets the iterval at which watchdog must be fed
      * @param watchdog_interval_usec
@@ -123,6 +219,147 @@ class MatrixDisplay : public display::DisplayBuffer {
         this->worker_idle_timeout_ms_ = ms;
     };
 
+    /**
+     * Sets the time budget (us) for flushing per update() or loop() call.
+     * A frame that does not fit is continued on the next call and only
+     * committed once complete; 0 flushes the whole frame in one call.
+     *
+     * @param us budget in microseconds
+     */
+    void set_flush_budget_us(uint32_t us) { this->flush_budget_us_ = us; };
+
+    /**
+     * Sets this display's position among the configured displays, which
+     * keys its stored SPI calibration. Fixed by the config, unlike setup
+     * order.
+     *
+     * @param index 0 for the first display
+     */
+    void set_instance_index(size_t index) { this->instance_index_ = index; };
+
+    /**
+     * Pins this display's SPI worker task to a core. With two displays,
+     * putting their workers on different cores lets both transfer at once.
+     *
+     * @param core 0 or 1
+     */
+    void set_worker_core(int core) { this->worker_core_ = core; };
+
+    /**
+     * Paces frames from loop() at a whole multiple of the panel's HUB75
+     * refresh period (read over status SPI) instead of the update_interval
+     * timer, dropping frames while a flush is still pending.
+     *
+     * @param enable true to pace frames to the panel refresh
+     */
+    void set_frame_pacing(bool enable) { this->frame_pacing_ = enable; };
+
+    /**
+     * Sets the window the latency histograms cover. Samples gather into a
+     * fresh set of histograms, which is published to readers whenever the
+     * window ends.
+     *
+     * @param ms window length in milliseconds
+     */
+    void set_latency_window_ms(uint32_t ms) { this->latency_window_ms_ = ms; };
+
+    /**
+     * Runs the writer on its own FreeRTOS task, rendering into one of three
+     * framebuffers while the flush sends the last completed one. Frames the
+     * flush has not picked up by the time the next one is done are dropped.
+     * The writer then runs on core 0 alongside the main loop, so it must
+     * only draw, and nothing else may draw on this display. Needs a content
+     * diff; setup() switches NONE to HASH.
+     *
+     * @param enable true to render off the main loop
+     */
+    void set_render_task(bool enable) { this->render_task_ = enable; };
+
+    /**
+     * Sets how many DMA staging buffers the flush rotates through. With two
+     * or more, the next chunk is packed while the worker is still sending
+     * the previous one; 1 restores the pack-then-wait behaviour.
+     *
+     * @param count number of buffers (1..kMaxStagingBuffers)
+     */
+    void set_staging_buffers(int count) {
+        this->staging_buffer_count_ = clamp(count, 1, kMaxStagingBuffers);
+    };
+
+    /**
+     * Sets the size of each DMA staging buffer. Runs of adjacent dirty
+     * chunks are merged into a single rect upload as long as the merged
+     * rect fits; a buffer always holds at least one full-height chunk.
+     *
+     * @param bytes staging buffer size in bytes
+     */
+    void set_staging_buffer_bytes(size_t bytes) {
+        this->staging_buffer_bytes_ = bytes;
+    };
+
+    /**
+     * Selects how written chunks are checked for real content change at
+     * flush time. Lambdas that clear and redraw the whole frame dirty every
+     * chunk; with a diff mode only rows that differ from what the FPGA
+     * already holds are sent.
+     *
+     * @param mode diff strategy
+     */
+    void set_content_diff(ContentDiffMode mode) {
+        this->content_diff_ = mode;
+    };
+
+    /**
+     * Selects the framebuffer storage format. RGB565 and RGB444 cut the
+     * framebuffer (and any shadow copy) by a third and a half respectively.
+     *
+     * @param format storage format
+     */
+    void set_pixel_format(PixelFormat format) {
+        this->pixel_format_ = format;
+    };
+
+    /**
+     * Selects where the framebuffer and its full-size companions (shadow
+     * copy, render slots) are allocated. Long chains need PSRAM.
+     *
+     * @param location memory to allocate from
+     */
+    void set_framebuffer_location(BufferLocation location) {
+        this->framebuffer_location_ = location;
+    };
+
+    /**
+     * Stores the framebuffer chunk by chunk instead of row by row, in
+     * DMA-capable internal RAM. Each chunk's dirty rows are then one
+     * contiguous RGB888 rect that the worker sends in place, with no pack
+     * step and no staging buffers. Needs RGB888, no panel layout and no
+     * colour correction; falls back to rows otherwise.
+     *
+     * @param tiled true for the chunk-major layout
+     */
+    void set_tiled_framebuffer(bool tiled) { this->tiled_ = tiled; };
+
+    /**
+     * Lets the flush send a chunk of flat content as fill commands (one per
+     * band of same-coloured rows) when that is cheaper than the raw rect.
+     *
+     * @param compress true to pick the smaller encoding per chunk
+     */
+    void set_compress_rects(bool compress) {
+        this->compress_rects_ = compress;
+    };
+
+    /**
+     * Sets the width of the column chunks used for dirty tracking and rect
+     * uploads. Narrow chunks keep sparse updates small; wide chunks pay
+     * less per-command overhead on full redraws.
+     *
+     * @param width chunk width in pixels (a power of two), or 0 to pick it
+     * at setup from the measured per-command cost
+     */
+    void set_chunk_width(int width) { this->requested_chunk_width_ = width; };
+
     /**
      * Gets the inital brightness value from this display.
      */
@@ -150,6 +387,61 @@ class MatrixDisplay : public display::DisplayBuffer {
         return static_cast<uint32_t>(this->update_time_sum_ /
                                      this->update_time_count_);
     }
+    /**
+     * Cumulative counters for the flush path. They only ever grow, so a
+     * reader takes two snapshots and divides the deltas by the frame delta to
+     * get per-frame figures over its own interval (see the flush_stat
+     * sensors).
+     */
+    struct FlushStats {
+        /// @brief update() calls that reached the render/flush path
+        uint32_t frames = 0;
+        /// @brief pixel payload bytes handed to the panel library
+        uint64_t bytes = 0;
+        /// @brief panel commands issued (rects, swap/copy, clears)
+        uint32_t commands = 0;
+        /// @brief time spent inside write_display_data(), in microseconds
+        uint64_t flush_micros = 0;
+        /// @brief frames committed to the panel with a swap
+        uint32_t commits = 0;
+        /// @brief frame slots frame pacing skipped (backpressure or a late
+        /// loop); render task drops are in get_dropped_frames()
+        uint32_t dropped = 0;
+        /// @brief summed |actual - target| interval between consecutive
+        /// frames, in microseconds, over jitter_samples intervals
+        uint64_t jitter_micros = 0;
+        uint32_t jitter_samples = 0;
+        /// @brief chunks re-sent after an integrity mismatch
+        uint32_t corrupt_chunks = 0;
+        /// @brief draw_asset() calls served from the cache, and misses
+        uint32_t asset_hits = 0;
+        uint32_t asset_misses = 0;
+        /// @brief time spent switched on and off (blanking counts as off),
+        /// in milliseconds
+        uint64_t on_millis = 0;
+        uint64_t off_millis = 0;
+    };
+
+    /**
+     * @return the cumulative flush counters since boot, with the current
+     * power state credited up to now.
+     */
+    FlushStats get_flush_stats() const;
+
+    /**
+     * @return per-frame latencies of one phase over the last completed
+     * latency window (empty until the first window ends).
+     */
+    const LatencyHistogram &get_latency(LatencyPhase phase) const {
+        return this->latency_window_[static_cast<size_t>(phase)];
+    }
+
+    /**
+     * @return frames the render task completed but the flush never sent,
+     * because a newer frame replaced them first.
+     */
+    uint32_t get_dropped_frames() const { return this->dropped_frames_.load(); }
+
     uint32_t get_reset_epoch() const {
         return this->dma_display_ ? this->dma_display_->get_reset_epoch() : 0;
     }
@@ -182,17 +474,19 @@ class MatrixDisplay : public display::DisplayBuffer {
     }
 
     /**
-     * Reads the FPGA status flags over the status SPI. Synchronous (takes
-     * the SPI mutex). False when the display isn't up, the status bus isn't
-     * configured, or no fresh frame could be read; failures are logged with
-     * the library's failure reason and the raw frame bytes.
+     * Reads the FPGA status flags. With the status poller running this is
+     * served from its latest snapshot and never touches the bus; otherwise
+     * it is a synchronous read (takes the SPI mutex). False when the display
+     * isn't up, the status bus isn't configured, or the last read failed;
+     * failures are logged with the library's failure reason and the raw
+     * frame bytes.
      */
     bool read_status_flags(MatrixPanel_FPGA_SPI::FpgaStatusFlags &out);
 
     /**
-     * Reads one FPGA status register over the status SPI. Same semantics and
-     * failure logging as read_status_flags; addr is a
-     * MatrixPanel_FPGA_SPI::STATUS_ADDR_* constant.
+     * Reads one FPGA status register. Same semantics and failure logging as
+     * read_status_flags; addr is a MatrixPanel_FPGA_SPI::STATUS_ADDR_*
+     * constant.
      */
     bool read_status_value(uint8_t addr, uint64_t &out);
 
@@ -202,6 +496,67 @@ class MatrixDisplay : public display::DisplayBuffer {
      */
     bool read_version(MatrixPanel_FPGA_SPI::FpgaVersion &out);
 
+    /**
+     * Adds a status register to the status poller's burst. Readers call this
+     * from setup() so the first snapshot already holds their register;
+     * a register read before it was requested is added on first use.
+     *
+     * @param addr a MatrixPanel_FPGA_SPI::STATUS_ADDR_* constant
+     */
+    void request_status(uint8_t addr) {
+        if (addr < kStatusSlots)
+            this->status_wanted_.fetch_or(1u << addr);
+    }
+
+    /**
+     * Enables SPI clock calibration: at boot the calibrated clock is loaded
+     * from flash, or found with calibrate_spi() if none is stored, and
+     * repeated link errors step the clock down at runtime.
+     *
+     * @param enable true to calibrate; spispeed becomes the known-good floor
+     */
+    void set_spi_calibration(bool enable) { this->spi_calibration_ = enable; };
+
+    /**
+     * Enables the end-to-end integrity check. The FPGA keeps a running 32-bit
+     * sum of every rect payload byte it receives in the given status
+     * register; after each group of rects drains, the sum is compared with
+     * what was sent and the chunks of a mismatching group are sent again.
+     * Needs the status SPI; costs one status read per group.
+     *
+     * @param addr status register address holding the payload sum
+     */
+    void set_integrity_register(uint8_t addr) {
+        this->integrity_addr_ = static_cast<int>(addr);
+    };
+
+    /**
+     * Starts stepping the SPI clock up from the configured spispeed, pushing
+     * a test pattern at each speed and checking it against the FPGA's own
+     * receive rate, flags and reset counter. Settles one step below the
+     * fastest clean speed and stores it. Runs from loop() in slices of at
+     * most kCalibrationSliceMs; frames are held back until it finishes and
+     * the whole frame is redrawn afterwards. Needs the status SPI.
+     *
+     * @return true if calibration started (or was already running)
+     */
+    bool calibrate_spi();
+
+    /// @brief true while a calibration started by calibrate_spi() runs
+    bool is_calibrating() const {
+        return this->calibration_stage_ != CalibrationStage::IDLE;
+    }
+
+    /**
+     * Sets how often the status poller task reads every requested register
+     * in one burst; 0 keeps status reads synchronous on the caller.
+     *
+     * @param ms poll interval in milliseconds
+     */
+    void set_status_poll_interval_ms(uint32_t ms) {
+        this->status_poll_interval_ms_ = ms;
+    };
+
     /**
      * Sets the clock speed
      *
@@ -211,16 +566,117 @@ class MatrixDisplay : public display::DisplayBuffer {
         this->mxconfig_.spispeed = speed;
     };
 
+    /**
+     * Fills the whole framebuffer with one colour in a single pass. Without
+     * a content diff the fill is also recorded and replayed on the FPGA as
+     * one fill command, so clearing every frame costs a few SPI bytes
+     * instead of a full upload. Display::clear() lands here.
+     *
+     * @param color fill colour
+     */
+    void fill(Color color) override;
+
+    /**
+     * Solid rectangle that, like fill(), writes whole rows and is replayed on
+     * the FPGA as a fill command. Display::filled_rectangle() is not virtual
+     * and cannot be intercepted, so call this directly, e.g.
+     * id(matrix).fill_rect(...). Falls back to filled_rectangle() while a
+     * rotation or clip rect is active.
+     *
+     * @param x left column
+     * @param y top row
+     * @param w width in pixels
+     * @param h height in pixels
+     * @param color fill colour
+     */
+    void fill_rect(int x, int y, int w, int h, Color color);
+
+    /**
+     * Bulk blit used by images and LVGL. Clips once, converts whole rows
+     * (a plain memcpy when the source already matches the framebuffer
+     * format) and marks dirty state once for the blitted rect instead of
+     * once per pixel. Rotated, clipped and 332 sources fall back to the
+     * per-pixel base implementation.
+     */
+    void draw_pixels_at(int x_start, int y_start, int w, int h,
+                        const uint8_t *ptr, display::ColorOrder order,
+                        display::ColorBitness bitness, bool big_endian,
+                        int x_offset, int y_offset, int x_pad) override;
+
+    /**
+     * Converts an image to the framebuffer format once and keeps it under an
+     * id, so draw_asset() can place it with row copies on every frame. The
+     * least recently drawn assets are evicted when the cache budget runs out.
+     * Caching an id again replaces it, once the new copy is allocated.
+     *
+     * @param id caller-chosen asset id
+     * @param w image width
+     * @param h image height
+     * @param ptr pixel data, row-major, in the given order and bitness (888
+     * or 565)
+     * @return false if the image is unsupported, larger than the budget or
+     * could not be allocated, or if called off the render task while there
+     * is one; the cache is then unchanged
+     */
+    bool cache_asset(uint16_t id, int w, int h, const uint8_t *ptr,
+                     display::ColorOrder order, display::ColorBitness bitness,
+                     bool big_endian);
+
+    /**
+     * Draws a cached asset with its top-left corner at (x, y). Rows that
+     * already hold the asset's pixels are left untouched and stay clean, so
+     * an icon redrawn in place costs no SPI traffic.
+     *
+     * @return false on a miss; cache the asset and draw it again. Also
+     * false, without counting a miss, when called off the render task while
+     * there is one.
+     */
+    bool draw_asset(uint16_t id, int x, int y);
+
+    /**
+     * Shifts the pixels inside a rect by (dx, dy) and fills the strips this
+     * exposes with `fill`. Meant for tickers and other scrolling content:
+     * only the exposed strips need redrawing, and rows whose pixels do not
+     * change under the shift (background above and below the text) stay
+     * clean.
+     *
+     * @param x left edge of the region
+     * @param y top edge of the region
+     * @param w region width
+     * @param h region height
+     * @param dx pixels to shift right; negative shifts left
+     * @param dy pixels to shift down; negative shifts up
+     * @param fill colour for the exposed strips
+     * @return false when clipping, rotation or the render task is active,
+     * in which case nothing is shifted
+     */
+    bool scroll_region(int x, int y, int w, int h, int dx, int dy,
+                       Color fill = display::COLOR_OFF);
+
+    /**
+     * Sets the memory budget for cached assets.
+     *
+     * @param bytes budget in bytes, in the framebuffer's pixel format
+     */
+    void set_asset_cache_bytes(size_t bytes) {
+        this->asset_cache_bytes_ = bytes;
+    };
+
     display::DisplayType get_display_type() override {
         return display::DisplayType::DISPLAY_TYPE_COLOR;
     }
 
     /**
-     * Sets the on/off state of the matrix display
+     * Switches the matrix display on or off. Switching off clears the panel
+     * once, after any pass in flight, and then suspends rendering and
+     * flushing. Switching on re-sends the whole framebuffer.
      *
      * @param state new state
      */
-    void set_state(bool state) { this->enabled_ = state; }
+    void set_state(bool state);
+
+    /// @return the current power state
+    PowerState get_power_state() const { return this->power_state_; }
 
     /**
      * Sets the brightness value of the display
@@ -229,6 +685,19 @@ class MatrixDisplay : public display::DisplayBuffer {
      */
     void set_brightness(int brightness);
 
+    /**
+     * Sets colour correction applied while chunks are packed: each channel
+     * goes through pow(v, gamma) and is then scaled by its white-balance
+     * gain. Gamma 1 with unit gains turns correction off, leaving the plain
+     * copy. The whole frame is re-sent with the new correction.
+     *
+     * @param gamma transfer exponent (> 0)
+     * @param red gain for the red channel (0-1)
+     * @param green gain for the green channel (0-1)
+     * @param blue gain for the blue channel (0-1)
+     */
+    void set_color_correction(float gamma, float red, float green, float blue);
+
     /**
      * Forces the display to show a known test graphic built from FPGA commands.
      */
@@ -267,10 +736,263 @@ class MatrixDisplay : public display::DisplayBuffer {
     void run_test_state_sequence_();
 
   protected:
+    /// @brief outcome of polling the SPI worker for idle
+    enum class WorkerWait : uint8_t { IDLE, PENDING, STALLED };
+
+    /**
+     * Waits for the SPI worker to drain until the deadline passes. The wait
+     * is tracked across calls, so a worker that stays busy for longer than
+     * worker_idle_timeout_ms_ in total is reported as stalled.
+     *
+     * @param deadline micros() value to give up at; ignored without a budget
+     * @return IDLE once drained, PENDING if the budget ran out first, or
+     *         STALLED (and a warning) if the worker timed out
+     */
+    WorkerWait poll_worker_idle_(uint32_t deadline);
+
+    /**
+     * Runs the flush state machine until the frame is committed or the
+     * deadline passes. Starts a new pass when none is pending.
+     *
+     * @param deadline micros() value to stop at; ignored without a budget
+     */
+    void flush_(uint32_t deadline);
+
+    /// @brief starts a new pass; false if there is nothing to send
+    bool begin_flush_();
+
+    /// @brief replays fills, diffs and sends dirty runs, then drains and
+    /// commits, until the deadline
+    void step_flush_(uint32_t deadline);
+
+    /// @brief diffs the dirty chunks from flush_cursor_ on; false if the
+    /// deadline passed before the last one
+    bool diff_chunks_(uint32_t deadline);
+
+    /// @brief swaps/copies the frame once every rect of the pass is drained
+    void finish_flush_();
+
+    /**
+     * Gives up on the pass after a stall: in-flight rects are re-marked and
+     * the next pass starts with them so the oldest changes go out first.
+     *
+     * @param chunk chunk the pass had reached
+     */
+    void abort_flush_(int chunk);
+
+    /// @brief recomputes dirty_any_ from the per-chunk dirty ranges and the
+    /// recorded fills
+    void refresh_dirty_any_();
+
+    /**
+     * Checks the drained in-flight group against the FPGA's payload sum and
+     * empties the group. On a mismatch its chunks are re-marked and, within
+     * kMaxIntegrityRetries per pass, the scan is rewound so they are sent
+     * again before the frame is committed.
+     *
+     * @return true if the scan was rewound
+     */
+    bool verify_group_();
+
+    /// @brief reads the integrity register, holding off the status poller
+    bool read_integrity_(uint64_t &value);
+
+    /// @brief takes the FPGA's payload sum as the new baseline
+    bool resync_integrity_();
+
+    /// @brief adds time to a phase of the frame in flight; recorded into its
+    /// histogram when the frame completes
+    void add_phase_micros_(LatencyPhase phase, uint32_t micros) {
+        this->phase_micros_[static_cast<size_t>(phase)] += micros;
+    }
+
+    /// @brief records one frame's time in a phase into its histogram
+    void record_phase_(LatencyPhase phase, uint32_t micros) {
+        this->latency_current_[static_cast<size_t>(phase)].record(micros);
+    }
+
+    /// @brief publishes the current histograms once the window has elapsed
+    void rotate_latency_window_();
+
+    /// @brief renders (or clears) and flushes one frame
+    void run_frame_();
+
+    /// @brief re-reads the panel refresh rate and retunes the pacing
+    /// interval, at most every kPacingRefreshMs
+    void refresh_pacing_();
+
+    /// @brief render task entry point; renders one frame per notification
+    static void render_task_fn_(void *arg);
+
+    /// @brief runs the writer into the draw slot and publishes it as ready
+    void render_frame_();
+
+    /**
+     * Swaps a newly published frame in as the flush source and marks every
+     * row for the content diff to sort out.
+     *
+     * @return true if a new frame was taken
+     */
+    bool take_ready_frame_();
+
     /// @brief Logs the library's failure reason and raw frame after a failed
     /// status read (callers guarantee dma_display_ is non-null).
     void log_status_read_failure_();
 
+    /**
+     * Re-creates the panel driver at another SPI clock (the library fixes
+     * the clock at construction and has no way to re-clock a live
+     * instance) and resyncs the display state to it. The old driver is
+     * only deleted once quiesce_driver_() has drained and stopped its
+     * worker; otherwise nothing changes.
+     *
+     * @param speed new SPI clock
+     * @return true if the panel came back up
+     */
+    bool restart_panel_(FPGA_SPI_CFG::clk_speed speed);
+
+    /**
+     * Waits up to worker_idle_timeout_ms_ for the SPI worker to finish the
+     * transfers it holds, then disables it. The driver's destructor stops
+     * the worker task and releases the SPI bus and DMA channel; running it
+     * under a live transfer would leave the DMA reading freed descriptors.
+     *
+     * @return false if the worker did not drain in time
+     */
+    bool quiesce_driver_();
+
+    /// @brief runs one slice of calibration: restarts the panel at the next
+    /// clock, pushes probe rects, or settles on the result
+    void step_calibration_();
+
+    /// @brief outcome of one probe slice
+    enum class ProbeStatus : uint8_t { RUNNING, PASSED, FAILED };
+
+    /// @brief starts pushing the probe pattern at the current clock
+    void begin_probe_();
+
+    /**
+     * Pushes probe rects until the slice deadline, and once kProbeMs have
+     * passed checks that the FPGA received it all without a stall, reset or
+     * fault.
+     *
+     * @param deadline millis() value to return at
+     * @return RUNNING until the probe is decided
+     */
+    ProbeStatus step_probe_(uint32_t deadline);
+
+    /// @brief restarts at the chosen clock and stores it
+    void finish_calibration_();
+
+    /// @brief counts a worker stall or FPGA reset towards a clock step-down
+    void note_link_error_();
+
+    /// @brief drops the SPI clock one step and stores it
+    void step_down_spi_();
+
+    /// @brief index of a clock in kClockSteps, or -1
+    static int clock_step_index_(FPGA_SPI_CFG::clk_speed speed);
+
+    /// @brief registers cached by the status poller: one slot per address
+    static constexpr uint8_t kStatusSlots = 16;
+
+    /// @brief status registers as of one poller burst
+    struct StatusSnapshot {
+        /// @brief bit per address whose last read succeeded
+        uint32_t valid = 0;
+        uint64_t values[kStatusSlots] = {};
+        MatrixPanel_FPGA_SPI::FpgaStatusFlags flags{};
+        MatrixPanel_FPGA_SPI::FpgaVersion version{};
+    };
+
+    /// @brief status poller task entry point
+    static void status_task_fn_(void *arg);
+
+    /// @brief reads every requested register and publishes the snapshot;
+    /// does nothing while status_paused_
+    void poll_status_();
+
+    /**
+     * Copies the latest status snapshot, retrying while the poller is
+     * writing it.
+     *
+     * @param addr register the caller is after; requested if it wasn't
+     * @param out snapshot copy
+     * @return true if the copy is consistent and holds a good read of addr
+     */
+    bool load_status_(uint8_t addr, StatusSnapshot &out);
+
+    /// @brief SPI clocks calibration may pick, slowest first
+    static constexpr FPGA_SPI_CFG::clk_speed kClockSteps[] = {
+        FPGA_SPI_CFG::HZ_8M,  FPGA_SPI_CFG::HZ_10M, FPGA_SPI_CFG::HZ_15M,
+        FPGA_SPI_CFG::HZ_16M, FPGA_SPI_CFG::HZ_20M, FPGA_SPI_CFG::HZ_26M,
+        FPGA_SPI_CFG::HZ_40M, FPGA_SPI_CFG::HZ_80M};
+    static constexpr int kClockStepCount =
+        sizeof(kClockSteps) / sizeof(kClockSteps[0]);
+    /// @brief how long each speed is probed; longer than the FPGA's
+    /// RX_KBPS averaging so the reading covers only the probe
+    static constexpr uint32_t kProbeMs = 2000;
+    /// @brief share of the sent rate the FPGA must report receiving
+    static constexpr uint32_t kProbeMinRxPercent = 90;
+    /// @brief steps kept below the fastest clean speed
+    static constexpr int kCalibrationMargin = 1;
+    /// @brief longest a loop() call spends pushing probe rects
+    static constexpr uint32_t kCalibrationSliceMs = 20;
+    /// @brief link errors within kLinkErrorWindowMs that step the clock down
+    static constexpr uint32_t kLinkErrorThreshold = 3;
+    static constexpr uint32_t kLinkErrorWindowMs = 60000;
+    /// @brief stored calibration, tied to the spispeed it was started from
+    struct SpiCalibration {
+        uint32_t speed;
+        uint32_t floor;
+    };
+    bool spi_calibration_ = false;
+    /// @brief spispeed from the config: calibration never starts below it
+    FPGA_SPI_CFG::clk_speed spi_floor_ = FPGA_SPI_CFG::HZ_20M;
+    ESPPreferenceObject spi_pref_;
+    uint32_t link_errors_ = 0;
+    uint32_t link_error_window_start_ms_ = 0;
+    bool link_step_down_pending_ = false;
+    /// @brief calibration progress: RESTART brings the panel up at the
+    /// clock being tried, PROBE pushes the test pattern at it, FINISH
+    /// settles on the result
+    enum class CalibrationStage : uint8_t { IDLE, RESTART, PROBE, FINISH };
+    CalibrationStage calibration_stage_ = CalibrationStage::IDLE;
+    /// @brief kClockSteps indices: configured floor, clock being tried and
+    /// fastest clean one so far (-1 for none)
+    int calibration_floor_ = 0;
+    int calibration_step_ = 0;
+    int calibration_best_ = -1;
+    /// @brief probe of the clock being tried
+    uint32_t probe_start_ms_ = 0;
+    uint32_t probe_send_ms_ = 0;
+    uint32_t probe_epoch_ = 0;
+    uint64_t probe_sent_ = 0;
+    int probe_x_ = 0;
+    bool probe_check_sum_ = false;
+
+    /// @brief status address of the FPGA's payload sum; -1 when off
+    int integrity_addr_ = -1;
+    /// @brief payload sum the FPGA should report once in-flight rects drain
+    uint32_t integrity_expected_ = 0;
+    /// @brief set when the FPGA's sum is unknown (boot, reset, stall)
+    bool integrity_resync_ = true;
+    /// @brief keeps the status poller, status reads and the watchdog timer
+    /// off the panel driver while restart_panel_() re-creates it
+    SemaphoreHandle_t panel_mutex_ = nullptr;
+
+    static constexpr uint32_t kStatusLoadSpinMicros = 100;
+    uint32_t status_poll_interval_ms_ = 1000;
+    TaskHandle_t status_task_handle_ = nullptr;
+    /// @brief bit per address the poller reads each burst
+    std::atomic<uint32_t> status_wanted_{0};
+    /// @brief set while the display is off, so the poller stays off the
+    /// status SPI too
+    std::atomic<bool> status_paused_{false};
+    /// @brief seqlock guarding status_snapshot_: odd while it is written
+    std::atomic<uint32_t> status_seq_{0};
+    StatusSnapshot status_snapshot_;
+
     /// @brief Wrapped matrix display
     MatrixPanel_FPGA_SPI *dma_display_ = nullptr;
 
@@ -317,8 +1039,34 @@ class MatrixDisplay : public display::DisplayBuffer {
         }
     }
 
-    /// @brief on-off status of the display matrix
-    bool enabled_ = false;
+    /// @brief cumulative flush counters, see get_flush_stats()
+    FlushStats flush_stats_;
+
+    /**
+     * Accounts one panel command issued from the update path.
+     *
+     * @param payload_bytes pixel bytes carried by the command (0 for control
+     * commands such as swap/copy/clear)
+     */
+    void note_command_(size_t payload_bytes) {
+        this->flush_stats_.commands++;
+        this->flush_stats_.bytes += payload_bytes;
+    }
+
+    /// @brief power state; see set_state()
+    PowerState power_state_ = PowerState::ON;
+    /// @brief millis() at the last power state change
+    uint32_t power_state_since_ms_ = 0;
+    bool suspend_watchdog_when_off_ = false;
+    /// @brief moves to a new power state, crediting the time spent in the
+    /// old one
+    void enter_power_state_(PowerState state);
+    /// @brief finishes the pass in flight, then clears the panel and enters
+    /// OFF
+    void blank_();
+    /// @brief consumes a pending FPGA reset and restores brightness and a
+    /// cleared frame; returns true when one was pending
+    bool resync_fpga_reset_();
 
     /// @brief power switches belonging to this matrix display
     std::vector<matrix_display_switch::MatrixDisplaySwitch *> power_switches_;
@@ -328,9 +1076,31 @@ class MatrixDisplay : public display::DisplayBuffer {
         brightness_values_;
 
     int get_width_internal() override {
-        return this->mxconfig_.mx_width * this->mxconfig_.chain_length;
+        return this->mxconfig_.mx_width *
+               (this->mxconfig_.chain_length / this->layout_rows_);
+    };
+    int get_height_internal() override {
+        return this->mxconfig_.mx_height * this->layout_rows_;
     };
-    int get_height_internal() override { return this->mxconfig_.mx_height; };
+
+    /// @brief layout requested through set_layout(), applied in setup()
+    int layout_rows_ = 1;
+    bool layout_serpentine_ = false;
+    std::vector<uint8_t> layout_turns_;
+    /// @brief logical canvas to chain mapping; dirty tracking and the
+    /// framebuffer stay logical, rects are split per panel when packed
+    PanelLayout layout_;
+    /// @brief scratch for PanelLayout::split(), sized to the chain at setup
+    std::vector<PanelLayout::Piece> pieces_;
+
+    /**
+     * Packs the logical pixels of one piece in the order its panel expects
+     * them, as a row-major RGB888 payload of chain_w x chain_h.
+     */
+    void pack_piece_(uint8_t *dst, const PanelLayout::Piece &piece) const;
+
+    /// @brief expands the framebuffer pixel at index to RGB888
+    void expand_pixel_(uint8_t *dst, const uint8_t *fb, size_t index) const;
 
     /**
      * Draws a single pixel on the display.
@@ -342,20 +1112,424 @@ class MatrixDisplay : public display::DisplayBuffer {
     void draw_absolute_pixel_internal(int x, int y, Color color) override;
     int cached_width_ = 0;
     int cached_height_ = 0;
-    static constexpr int kChunkWidth = 16;
+    /// @brief chunk width used unless configured otherwise, and by auto when
+    /// the command cost could not be measured
+    static constexpr int kDefaultChunkWidth = 16;
+    /// @brief narrowest/widest chunk the auto choice may pick
+    static constexpr int kMinChunkWidth = 4;
+    static constexpr int kMaxChunkWidth = 64;
+    /// @brief configured chunk width in pixels (power of two), 0 = auto
+    int requested_chunk_width_ = kDefaultChunkWidth;
+    /// @brief chunk width in effect; edge chunks may be narrower
+    int chunk_width_ = kDefaultChunkWidth;
+    /// @brief log2(chunk_width_), maps a column to its chunk with a shift
+    int chunk_shift_ = 4;
+    /// @brief sets chunk_width_ (rounded down to a power of two) and sizes
+    /// the dirty map and row hashes for it
+    void configure_chunks_(int width);
+
+    /**
+     * Picks the chunk width for the "auto" setting: the narrowest power of
+     * two whose full-height chunk carries at least the given multiple of
+     * command_overhead_bytes_. A tiled framebuffer sends every dirty chunk
+     * as its own command, so it asks for kTiledChunkOverheadRatio; row-major
+     * merges adjacent chunks into one rect and only pays the overhead per
+     * isolated change, so narrow chunks win there. The width is capped by
+     * the staging buffer, and by the panel width on a remapped layout,
+     * which cuts rects at panel edges anyway.
+     */
+    int auto_chunk_width_() const;
+    static constexpr size_t kTiledChunkOverheadRatio = 16;
+    static constexpr size_t kRowChunkOverheadRatio = 4;
     bool use_watchdog = false;
     int watchdog_interval_usec = 1000000;
     /// @brief max time (ms) a flush waits for the SPI worker before giving up on
     /// the frame; keeps an unresponsive FPGA from making update() block forever
     uint32_t worker_idle_timeout_ms_ = 1500;
     uint32_t watchdog_last_checkin = 0;
-    esp_timer_handle_t periodic_timer;
-    std::vector<uint8_t> dirty_chunks_;
-    uint8_t *chunk_buffer_ = nullptr;
+    esp_timer_handle_t periodic_timer = nullptr;
+    /// @brief dirty row range of one chunk; the chunk is clean while
+    /// y_min > y_max, so a flush only sends rows y_min..y_max
+    struct ChunkDirty {
+        int16_t y_min = INT16_MAX;
+        int16_t y_max = -1;
+
+        /// @brief send the rows without diffing (reference is stale)
+        bool force = false;
+
+        bool is_dirty() const { return this->y_min <= this->y_max; }
+        void mark(int y) {
+            if (y < this->y_min)
+                this->y_min = static_cast<int16_t>(y);
+            if (y > this->y_max)
+                this->y_max = static_cast<int16_t>(y);
+        }
+        void clear() {
+            this->y_min = INT16_MAX;
+            this->y_max = -1;
+            this->force = false;
+        }
+    };
+    std::vector<ChunkDirty> dirty_chunks_;
+
+    /// @brief marks every chunk dirty over the full panel height, so the next
+    /// flush re-sends the whole framebuffer
+    void mark_all_dirty_() {
+        for (ChunkDirty &dirty : this->dirty_chunks_) {
+            dirty.y_min = 0;
+            dirty.y_max = static_cast<int16_t>(this->cached_height_ - 1);
+            dirty.force = true;
+        }
+        this->dirty_any_ = !this->dirty_chunks_.empty();
+    }
+    /// @brief writes one pixel into buffer_ in the configured format
+    void store_pixel_(size_t index, Color color) {
+        this->store_pixel_to_(this->buffer_, index, color);
+    }
+    /// @brief writes one pixel into a buffer in the framebuffer's format
+    void store_pixel_to_(uint8_t *fb, size_t index, Color color) const;
+    /// @brief reads one pixel back from a buffer in the framebuffer's format
+    Color load_pixel_(const uint8_t *fb, size_t index) const;
+
+    /// @brief a cached image in the framebuffer's pixel format
+    struct Asset {
+        uint16_t id;
+        int16_t w;
+        int16_t h;
+        /// @brief asset_clock_ at the last draw or cache, for LRU eviction
+        uint32_t last_used;
+        size_t bytes;
+        uint8_t *data;
+    };
+    std::vector<Asset> assets_;
+    size_t asset_cache_bytes_ = 16384;
+    size_t asset_bytes_used_ = 0;
+    uint32_t asset_clock_ = 0;
+    /// @brief frees an asset and drops it from assets_
+    void evict_asset_(size_t slot);
+    /// @brief draw_asset() hits and misses, counted apart from flush_stats_
+    /// because the render task bumps them while sensors read them
+    std::atomic<uint32_t> asset_hits_{0};
+    std::atomic<uint32_t> asset_misses_{0};
+
+    /**
+     * With a render task, only the display lambda on that task may draw:
+     * it swaps buffer_ between frame slots and owns the asset cache. Any
+     * other task's drawing call is refused, with one warning.
+     *
+     * @param call name of the refused call, for the log
+     * @return true if the caller must return without drawing
+     */
+    bool foreign_draw_(const char *call);
+    bool foreign_draw_warned_ = false;
+
+    /// @brief one framebuffer row, gathered by scroll_region() before it is
+    /// written back shifted; grown on first use
+    std::vector<uint8_t> scroll_row_;
+    /// @brief writes a run of one colour into buffer_ from a pixel index;
+    /// callers keep it within a row segment (see span_end_()) or cover the
+    /// whole buffer
+    void fill_span_(size_t index, int w, Color color);
+
+    /**
+     * Index of a pixel in buffer_. Row-major by default; with a tiled
+     * framebuffer each chunk's pixels are stored together, row-major within
+     * the chunk, so any band of a chunk's rows is one contiguous rect.
+     */
+    size_t pixel_index_(int x, int y) const {
+        if (!this->tiled_)
+            return static_cast<size_t>(y) * this->cached_width_ + x;
+        const int chunk_x = (x >> this->chunk_shift_) << this->chunk_shift_;
+        const int chunk_w =
+            std::min(this->chunk_width_, this->cached_width_ - chunk_x);
+        // Every chunk before this one is full width.
+        return static_cast<size_t>(chunk_x) * this->cached_height_ +
+               static_cast<size_t>(y) * chunk_w + (x - chunk_x);
+    }
+
+    /// @brief end (exclusive, capped at x1) of the row segment starting at x
+    /// that is contiguous in buffer_
+    int span_end_(int x, int x1) const {
+        if (!this->tiled_)
+            return x1;
+        return std::min(x1, ((x >> this->chunk_shift_) + 1)
+                                << this->chunk_shift_);
+    }
+    /// @brief marks the chunks covering a rect dirty over its rows
+    void mark_rect_dirty_(int x, int y, int w, int h);
+
+    /// @brief a solid rect fill recorded for replay on the FPGA
+    struct FillPrimitive {
+        int16_t x, y, w, h;
+        uint8_t r, g, b;
+    };
+    /// @brief fills recorded per frame before further ones fall back to
+    /// dirty marking
+    static constexpr uint8_t kMaxPendingFills = 8;
+    FillPrimitive pending_fills_[kMaxPendingFills];
+    uint8_t pending_fill_count_ = 0;
+    /// @brief queues a fill for replay; the rect is already in buffer_
+    void record_fill_(int x, int y, int w, int h, Color color);
+    /// @brief next recorded fill to send in the current pass
+    uint8_t replay_cursor_ = 0;
+    /// @brief sends the recorded fills, in order, ahead of the rect uploads;
+    /// false if the deadline passed before the last one went out
+    bool replay_fills_(uint32_t deadline);
+
+    /**
+     * Narrows a dirty chunk to the rows whose content differs from what the
+     * FPGA holds, and records those rows as sent in the diff reference.
+     *
+     * @return false if nothing changed (the chunk is then marked clean)
+     */
+    bool diff_chunk_(int chunk, ChunkDirty &dirty);
+
+    /// @brief framebuffer storage format, see set_pixel_format()
+    PixelFormat pixel_format_ = PixelFormat::RGB888;
+
+    /// @brief see set_framebuffer_location()
+    BufferLocation framebuffer_location_ = BufferLocation::AUTO;
+    /// @brief chunk-major framebuffer sent in place, see
+    /// set_tiled_framebuffer()
+    bool tiled_ = false;
+    /// @brief size of the framebuffer and of each full-size companion
+    size_t frame_bytes_ = 0;
+    /// @brief whether each full-size buffer landed in PSRAM, for dump_config
+    bool framebuffer_psram_ = false;
+    bool shadow_psram_ = false;
+    bool frames_psram_ = false;
+
+    /**
+     * Allocates a zeroed full-size buffer from framebuffer_location_.
+     *
+     * @param bytes buffer size
+     * @param dma allocate from internal DMA-capable RAM, whatever the
+     * configured location
+     * @param psram set to whether the buffer is in PSRAM
+     * @return the buffer, or nullptr if the location has no room
+     */
+    uint8_t *alloc_frame_(size_t bytes, bool dma, bool &psram) const;
+
+    /**
+     * @return bytes taken by `pixels` consecutive framebuffer pixels. For
+     * RGB444 the run must start on an even pixel index and hold an even
+     * number of pixels.
+     */
+    size_t fb_bytes_(size_t pixels) const {
+        switch (this->pixel_format_) {
+        case PixelFormat::RGB565:
+            return pixels * 2;
+        case PixelFormat::RGB444:
+            return pixels * 3 / 2;
+        case PixelFormat::RGB888:
+        default:
+            return pixels * 3;
+        }
+    }
+
+    /**
+     * Expands one run of framebuffer pixels to the RGB888 wire format.
+     *
+     * @param dst destination, pixels * 3 bytes
+     * @param src framebuffer bytes for the run
+     * @param pixels run length (even for RGB444)
+     */
+    void expand_row_(uint8_t *dst, const uint8_t *src, int pixels) const;
+
+    /// @brief per-channel colour correction tables, see
+    /// set_color_correction(); only consulted while color_lut_active_
+    uint8_t color_lut_[3][256];
+    bool color_lut_active_ = false;
+
+    /// @brief pick fills over raw rects for flat spans when cheaper, see
+    /// set_compress_rects()
+    bool compress_rects_ = false;
+    /// @brief a fill the span encoder is still growing down the rect
+    struct SpanFill {
+        int16_t x, y, w, h;
+        uint8_t r, g, b;
+    };
+    /// @brief most fills the span encoder keeps open across a row; further
+    /// flat spans in that row are sent raw
+    static constexpr int kMaxOpenFills = 8;
+    /// @brief bytes a rect or fill command carries ahead of its payload or
+    /// colour: an opcode and the four int16_t coordinates both calls take
+    static constexpr size_t kRectHeaderBytes = 1 + 4 * sizeof(int16_t);
+    /// @brief fixed cost of one command (header, transfer set-up, BUSY
+    /// handshake) in payload bytes sent in the same time at the current
+    /// clock; the bare header until measure_command_cost_() has run
+    size_t command_overhead_bytes_ = kRectHeaderBytes;
+    /// @brief single-pixel rects timed by measure_command_cost_()
+    static constexpr int kCostProbeCommands = 16;
+
+    /// @brief estimated wire cost of one raw rect upload. A fill costs what
+    /// a one-pixel rect does: the same command, with its colour in place of
+    /// the payload.
+    size_t rect_cost_(int w, int h) const {
+        return static_cast<size_t>(w) * h * 3 + this->command_overhead_bytes_;
+    }
+
+    /**
+     * Measures command_overhead_bytes_ on a fresh driver: times
+     * kCostProbeCommands single-pixel rects against one staging-buffer-sized
+     * rect, with the worker paused so every call returns only once it is on
+     * the wire. The rects land in the back buffer, which the full upload
+     * that follows a (re)start overwrites before the next swap.
+     *
+     * @return false if the measurement could not run or was inconclusive
+     */
+    bool measure_command_cost_();
+
+    /// @brief sends a packed RGB888 rect as one raw rect command
+    void send_raw_(int x, int y, int w, int h, uint8_t *payload);
+
+    /**
+     * Run-length encodes each row of a packed RGB888 rect into spans of one
+     * colour. Spans long enough to pay for a command become fills, grown
+     * down the rect while the rows below repeat them; the pixels between
+     * them become single-row raw rects, and rows with no fill at all are
+     * grouped into raw bands.
+     *
+     * @param send issue the commands; false only prices the encoding
+     * @param raw_sent set when a raw rect (from the staging buffer) is part
+     * of the encoding
+     * @return wire cost of the encoding, see rect_cost_()
+     */
+    size_t encode_spans_(int x, int y, int w, int h, uint8_t *rgb, bool send,
+                         bool &raw_sent);
+
+    /**
+     * Sends a packed RGB888 rect as fills for its flat spans plus raw rects
+     * for the rest, if that is cheaper than the raw upload.
+     *
+     * @param raw_sent set when part of the rect still went out raw, so the
+     * staging buffer is in flight
+     * @return true if the rect was sent
+     */
+    bool send_as_fills_(int x, int y, int w, int h, uint8_t *rgb,
+                        bool &raw_sent);
+
+    /// @brief content diff strategy, see set_content_diff()
+    ContentDiffMode content_diff_ = ContentDiffMode::NONE;
+    /// @brief SHADOW mode: last framebuffer contents sent to the FPGA
+    uint8_t *shadow_buffer_ = nullptr;
+    /// @brief HASH mode: hash of each chunk row last sent, chunk-major
+    std::vector<uint32_t> row_hashes_;
+
+    /// @brief upper bound for staging_buffers, sizes the flush's in-flight
+    /// bookkeeping
+    static constexpr int kMaxStagingBuffers = 4;
+    /// @brief requested number of DMA staging buffers
+    int staging_buffer_count_ = 2;
+    /// @brief requested staging buffer size; runs of adjacent dirty chunks
+    /// are merged into one rect up to this many RGB888 bytes
+    size_t staging_buffer_bytes_ = 8192;
+    /// @brief DMA-capable staging buffers, packed in rotation
+    std::vector<uint8_t *> chunk_buffers_;
     size_t chunk_buffer_bytes_ = 0;
     int chunk_count_ = 0;
     bool dirty_any_ = false; // Fast path: skip flushing when no columns changed.
 
+    static constexpr size_t kLatencyPhases = 5;
+    /// @brief histograms being filled, and the last completed window
+    LatencyHistogram latency_current_[kLatencyPhases];
+    LatencyHistogram latency_window_[kLatencyPhases];
+    uint32_t latency_window_ms_ = 60000;
+    uint32_t latency_window_start_ms_ = 0;
+    /// @brief per-phase time of the frame in flight, which may span
+    /// several budgeted flush calls
+    uint32_t phase_micros_[kLatencyPhases] = {};
+    /// @brief writer duration of the last frame the render task published
+    std::atomic<uint32_t> render_micros_{0};
+
+    /// @brief run frames from loop() on a multiple of the panel refresh
+    bool frame_pacing_ = false;
+    /// @brief current paced frame interval; 0 while pacing is off
+    uint32_t pacing_interval_us_ = 0;
+    uint32_t next_frame_us_ = 0;
+    /// @brief HUB75 refresh period last read back; 0 if unknown
+    uint32_t pacing_period_us_ = 0;
+    /// @brief refresh periods per frame: the smallest that honours
+    /// update_interval, raised while the flush can't keep up
+    uint32_t pacing_multiplier_ = 1;
+    static constexpr uint32_t kMaxPacingBackoff = 4;
+    static constexpr uint32_t kPacingRefreshMs = 5000;
+    uint32_t last_pacing_refresh_ms_ = 0;
+    /// @brief counters at the start of the current pacing window
+    FlushStats pacing_window_{};
+    /// @brief start of the previous frame, for jitter; 0 before the first
+    uint32_t last_frame_us_ = 0;
+    /// @brief a slot was dropped since the previous frame, so its interval
+    /// is not a jitter sample
+    bool frame_skipped_ = false;
+    HighFrequencyLoopRequester high_freq_;
+
+    /// @brief render the writer on its own task into rotating framebuffers.
+    /// Drawing then leaves the dirty ranges alone: they belong to the flush,
+    /// which marks whole frames as they are taken.
+    bool render_task_ = false;
+    TaskHandle_t render_task_handle_ = nullptr;
+    static constexpr uint8_t kFrameSlots = 3;
+    uint8_t *frames_[kFrameSlots] = {};
+    /// @brief slot holding the latest completed frame, exchanged by both
+    /// sides; kSlotFresh is set until the flush takes it
+    std::atomic<uint8_t> ready_slot_{1};
+    static constexpr uint8_t kSlotFresh = 0x80;
+    static constexpr uint8_t kSlotIndex = 0x7F;
+    /// @brief slot the render task draws into (render task only)
+    uint8_t draw_slot_ = 0;
+    /// @brief slot the flush reads from (flush side only)
+    uint8_t flush_slot_ = 2;
+    /// @brief framebuffer the flush packs from: buffer_, or the taken slot
+    const uint8_t *flush_buffer_ = nullptr;
+    std::atomic<uint32_t> dropped_frames_{0};
+
+    /// @brief flush pass progress: REPLAYING sends recorded fills, DIFFING
+    /// drops unchanged rows, SENDING packs and queues dirty runs, DRAINING
+    /// waits for the worker before the frame is committed
+    enum class FlushState : uint8_t { IDLE, REPLAYING, DIFFING, SENDING, DRAINING };
+    FlushState flush_state_ = FlushState::IDLE;
+    /// @brief per-call flush time budget in microseconds; 0 = unlimited
+    uint32_t flush_budget_us_ = 0;
+    /// @brief core the library's SPI worker task is pinned to
+    int worker_core_ = 1;
+
+    /// @brief position of this display among the configured ones
+    size_t instance_index_ = 0;
+    /// @brief chunk the pass starts scanning at; moved to the oldest
+    /// unsent chunk after a stall so starved chunks go out first
+    int flush_start_chunk_ = 0;
+    /// @brief chunks scanned so far in the current pass
+    int flush_cursor_ = 0;
+    /// @brief at least one command was issued in the current pass
+    bool flush_any_sent_ = false;
+    /// @brief the worker must be seen idle before a staging buffer is packed
+    bool flush_need_idle_ = false;
+    /// @brief a stalled pass left the worker sending from the tiled
+    /// framebuffer; the writer waits until it drains
+    bool tiled_hold_ = false;
+    /// @brief whether tiled_hold_ still applies; clears it once the worker
+    /// is idle
+    bool tiled_in_use_();
+    /// @brief a rect handed to the worker since it was last seen idle. The
+    /// worker only reports "idle", not per-job completion, so a buffer is
+    /// reused only after a wait has drained all of them.
+    struct InFlight {
+        int first_chunk;
+        int last_chunk;
+        ChunkDirty rows;
+    };
+    InFlight in_flight_[kMaxStagingBuffers];
+    size_t in_flight_count_ = 0;
+    /// @brief damaged groups re-sent within one pass before it is committed
+    /// regardless, leaving the rest to the next pass
+    static constexpr uint8_t kMaxIntegrityRetries = 3;
+    uint8_t integrity_retries_ = 0;
+    size_t next_buffer_ = 0;
+    /// @brief a worker wait is in progress; it may span several calls
+    bool worker_waiting_ = false;
+    uint32_t worker_wait_start_ms_ = 0;
+
     bool test_state_active_ = false;
     bool test_state_dirty_ = false;
 };
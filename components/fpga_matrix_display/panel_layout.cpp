@@ -0,0 +1,96 @@
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+#include "panel_layout.h"
+
+#include <algorithm>
+
+namespace esphome {
+namespace matrix_display {
+
+void PanelLayout::configure(int panel_width, int panel_height, int rows,
+                            int chain_length, bool serpentine,
+                            const std::vector<uint8_t> &quarter_turns) {
+    this->panel_width_ = panel_width;
+    this->panel_height_ = panel_height;
+    this->rows_ = std::max(1, rows);
+    this->columns_ = std::max(1, chain_length / this->rows_);
+    this->serpentine_ = serpentine;
+    this->identity_ = this->rows_ == 1;
+    this->cells_.assign(static_cast<size_t>(this->rows_) * this->columns_,
+                        Placement{0, 0});
+    for (int row = 0; row < this->rows_; ++row) {
+        for (int column = 0; column < this->columns_; ++column) {
+            const bool reversed = serpentine && (row & 1) != 0;
+            const int panel = row * this->columns_ +
+                              (reversed ? this->columns_ - 1 - column : column);
+            uint8_t turns = static_cast<size_t>(panel) < quarter_turns.size()
+                                ? quarter_turns[static_cast<size_t>(panel)] & 3
+                                : 0;
+            // A quarter turn swaps the panel's axes; only square panels
+            // still fit their cell.
+            if ((turns & 1) != 0 && panel_width != panel_height)
+                turns = 0;
+            if (turns != 0)
+                this->identity_ = false;
+            this->cells_[static_cast<size_t>(row) * this->columns_ + column] = {
+                panel * panel_width, turns};
+        }
+    }
+}
+
+void PanelLayout::split(int x, int y, int w, int h,
+                        std::vector<Piece> &out) const {
+    out.clear();
+    if (this->identity_) {
+        out.push_back({x, y, w, h, x, y, w, h, 0});
+        return;
+    }
+    const int pw = this->panel_width_;
+    const int ph = this->panel_height_;
+    for (int row = y / ph; row <= (y + h - 1) / ph; ++row) {
+        const int cell_y = row * ph;
+        const int y0 = std::max(y, cell_y);
+        const int y1 = std::min(y + h, cell_y + ph);
+        for (int column = x / pw; column <= (x + w - 1) / pw; ++column) {
+            const int cell_x = column * pw;
+            const int x0 = std::max(x, cell_x);
+            const int x1 = std::min(x + w, cell_x + pw);
+            const Placement &cell =
+                this->cells_[static_cast<size_t>(row) * this->columns_ + column];
+            // Panel-local rect, then its image under the panel's rotation.
+            const int u = x0 - cell_x;
+            const int v = y0 - cell_y;
+            const int lw = x1 - x0;
+            const int lh = y1 - y0;
+            Piece piece{x0, y0, lw, lh, 0, 0, lw, lh, cell.quarter_turns};
+            int cu = u;
+            int cv = v;
+            switch (cell.quarter_turns) {
+            case 1:
+                cu = v;
+                cv = pw - u - lw;
+                piece.chain_w = lh;
+                piece.chain_h = lw;
+                break;
+            case 2:
+                cu = pw - u - lw;
+                cv = ph - v - lh;
+                break;
+            case 3:
+                cu = ph - v - lh;
+                cv = u;
+                piece.chain_w = lh;
+                piece.chain_h = lw;
+                break;
+            default:
+                break;
+            }
+            piece.chain_x = cell.chain_x + cu;
+            piece.chain_y = cv;
+            out.push_back(piece);
+        }
+    }
+}
+
+} // namespace matrix_display
+} // namespace esphome
@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace esphome {
+namespace matrix_display {
+
+/**
+ * Maps the logical canvas of a grid of panels onto the FPGA's single
+ * horizontal chain. Panels are wired in chain order starting at the top-left
+ * cell, row by row; with serpentine wiring every other row runs right to
+ * left. Each panel may be mounted rotated by a multiple of 90 degrees
+ * (clockwise); 90 and 270 need square panels.
+ *
+ * The table is built once, so a rect is mapped by splitting it at panel
+ * boundaries rather than by translating every pixel.
+ */
+class PanelLayout {
+  public:
+    /// One panel-sized (or smaller) part of a logical rect and where it lands
+    /// on the chain.
+    struct Piece {
+        /// @brief logical rect
+        int x, y, w, h;
+        /// @brief rect on the chain; w/h swap for 90 and 270
+        int chain_x, chain_y, chain_w, chain_h;
+        /// @brief panel rotation in quarter turns clockwise (0-3)
+        uint8_t quarter_turns;
+    };
+
+    /**
+     * Builds the placement table.
+     *
+     * @param panel_width width of one panel
+     * @param panel_height height of one panel
+     * @param rows panel rows in the grid; the chain length must divide by it
+     * @param chain_length panels on the chain
+     * @param serpentine odd rows are wired right to left
+     * @param quarter_turns rotation of each panel in chain order (0-3);
+     * missing entries mean unrotated
+     */
+    void configure(int panel_width, int panel_height, int rows,
+                   int chain_length, bool serpentine,
+                   const std::vector<uint8_t> &quarter_turns);
+
+    int width() const { return this->panel_width_ * this->columns_; }
+    int height() const { return this->panel_height_ * this->rows_; }
+    int rows() const { return this->rows_; }
+    int columns() const { return this->columns_; }
+    bool serpentine() const { return this->serpentine_; }
+
+    /// @brief true when logical and chain coordinates coincide (one row, no
+    /// rotation)
+    bool is_identity() const { return this->identity_; }
+
+    /**
+     * Splits a logical rect at panel boundaries.
+     *
+     * @param out receives one piece per panel the rect covers, in logical
+     * row-major panel order; cleared first
+     */
+    void split(int x, int y, int w, int h, std::vector<Piece> &out) const;
+
+  protected:
+    /// @brief where the panel at a logical grid cell sits on the chain
+    struct Placement {
+        int chain_x;
+        uint8_t quarter_turns;
+    };
+
+    int panel_width_ = 0;
+    int panel_height_ = 0;
+    int rows_ = 1;
+    int columns_ = 1;
+    bool serpentine_ = false;
+    bool identity_ = true;
+    /// @brief one entry per grid cell, row-major
+    std::vector<Placement> cells_;
+};
+
+} // namespace matrix_display
+} // namespace esphome
@@ -8,12 +8,16 @@ from esphome.const import (
     DEVICE_CLASS_DATA_RATE,
     DEVICE_CLASS_DURATION,
     DEVICE_CLASS_FREQUENCY,
+    ICON_COUNTER,
+    ICON_MEMORY,
+    ICON_PERCENT,
     ICON_TIMER,
     STATE_CLASS_MEASUREMENT,
     STATE_CLASS_TOTAL_INCREASING,
+    UNIT_PERCENT,
 )
 
-from ..display import MATRIX_ID, MatrixDisplay
+from ..display import MATRIX_ID, MatrixDisplay, matrix_display_ns
 
 matrix_display_update_duration_ns = cg.esphome_ns.namespace(
     "matrix_display::matrix_display_update_duration"
@@ -29,6 +33,58 @@ MatrixDisplayStatusValue = matrix_display_status_value_ns.class_(
     "MatrixDisplayStatusValue", sensor.Sensor, cg.PollingComponent
 )
 
+matrix_display_flush_stat_ns = cg.esphome_ns.namespace(
+    "matrix_display::matrix_display_flush_stat"
+)
+MatrixDisplayFlushStat = matrix_display_flush_stat_ns.class_(
+    "MatrixDisplayFlushStat", sensor.Sensor, cg.PollingComponent
+)
+FlushStatType = matrix_display_flush_stat_ns.enum("FlushStatType", is_class=True)
+
+# Per-frame averages of the display's cumulative flush counters, computed
+# on the ESP32 (no status SPI needed).
+FLUSH_STAT_TYPES = {
+    "bytes_per_frame": FlushStatType.BYTES_PER_FRAME,
+    "commands_per_frame": FlushStatType.COMMANDS_PER_FRAME,
+    "flush_duration": FlushStatType.FLUSH_DURATION,
+    "achieved_fps": FlushStatType.ACHIEVED_FPS,
+    "dropped_frames": FlushStatType.DROPPED_FRAMES,
+    "frame_jitter": FlushStatType.FRAME_JITTER,
+    "corrupt_chunks": FlushStatType.CORRUPT_CHUNKS,
+    "throughput": FlushStatType.THROUGHPUT,
+    "asset_hit_rate": FlushStatType.ASSET_HIT_RATE,
+    "on_time": FlushStatType.ON_TIME,
+    "off_time": FlushStatType.OFF_TIME,
+}
+
+matrix_display_latency_ns = cg.esphome_ns.namespace(
+    "matrix_display::matrix_display_latency"
+)
+MatrixDisplayLatency = matrix_display_latency_ns.class_(
+    "MatrixDisplayLatency", sensor.Sensor, cg.PollingComponent
+)
+LatencyStatistic = matrix_display_latency_ns.enum("LatencyStatistic", is_class=True)
+LatencyPhase = matrix_display_ns.enum("LatencyPhase", is_class=True)
+
+CONF_PHASE = "phase"
+CONF_STATISTIC = "statistic"
+
+# Frame phases timed into the display's latency histograms.
+LATENCY_PHASES = {
+    "render": LatencyPhase.RENDER,
+    "pack": LatencyPhase.PACK,
+    "wait": LatencyPhase.WAIT,
+    "transfer": LatencyPhase.TRANSFER,
+    "swap": LatencyPhase.SWAP,
+}
+LATENCY_STATISTICS = {
+    "min": LatencyStatistic.MIN,
+    "max": LatencyStatistic.MAX,
+    "p50": LatencyStatistic.P50,
+    "p95": LatencyStatistic.P95,
+    "p99": LatencyStatistic.P99,
+}
+
 # Status register addresses come from the C++ header (MatrixPanel_FPGA_SPI
 # STATUS_ADDR_* constants) so the address values live in one place.
 MatrixPanelConstants = cg.global_ns.namespace("MatrixPanel_FPGA_SPI")
@@ -55,6 +111,19 @@ def _status_value_schema(default_update_interval, **sensor_kwargs):
     )
 
 
+def _flush_stat_schema(**sensor_kwargs):
+    """Schema for a sensor publishing one per-frame flush figure."""
+    return (
+        sensor.sensor_schema(
+            MatrixDisplayFlushStat,
+            state_class=STATE_CLASS_MEASUREMENT,
+            **sensor_kwargs,
+        )
+        .extend(MATRIX_SCHEMA)
+        .extend(cv.polling_component_schema("60s"))
+    )
+
+
 CONFIG_SCHEMA = cv.typed_schema(
     {
         "update_duration": sensor.sensor_schema(
@@ -96,6 +165,87 @@ CONFIG_SCHEMA = cv.typed_schema(
             device_class=DEVICE_CLASS_DURATION,
             state_class=STATE_CLASS_TOTAL_INCREASING,
         ),
+        # Pixel payload bytes sent to the FPGA per frame.
+        "bytes_per_frame": _flush_stat_schema(
+            unit_of_measurement="B",
+            icon=ICON_MEMORY,
+            accuracy_decimals=0,
+        ),
+        # Panel commands (rects, swap/copy, clears) issued per frame.
+        "commands_per_frame": _flush_stat_schema(
+            icon=ICON_COUNTER,
+            accuracy_decimals=1,
+        ),
+        # Time spent in write_display_data() per frame.
+        "flush_duration": _flush_stat_schema(
+            unit_of_measurement="µs",
+            icon=ICON_TIMER,
+            accuracy_decimals=0,
+        ),
+        # One statistic of a frame phase's latency over the display's last
+        # completed latency window.
+        "latency": sensor.sensor_schema(
+            MatrixDisplayLatency,
+            unit_of_measurement="µs",
+            icon=ICON_TIMER,
+            accuracy_decimals=0,
+            state_class=STATE_CLASS_MEASUREMENT,
+        )
+        .extend(
+            {
+                cv.Required(CONF_PHASE): cv.enum(LATENCY_PHASES, lower=True),
+                cv.Optional(CONF_STATISTIC, default="p95"): cv.enum(
+                    LATENCY_STATISTICS, lower=True
+                ),
+            }
+        )
+        .extend(MATRIX_SCHEMA)
+        .extend(cv.polling_component_schema("60s")),
+        # Frames swapped onto the panel per second.
+        "achieved_fps": _flush_stat_schema(
+            unit_of_measurement="Hz",
+            device_class=DEVICE_CLASS_FREQUENCY,
+            accuracy_decimals=1,
+        ),
+        # Frames dropped by frame pacing or the render task per interval.
+        "dropped_frames": _flush_stat_schema(
+            icon=ICON_COUNTER,
+            accuracy_decimals=0,
+        ),
+        # Mean deviation of the frame-to-frame interval from its target.
+        "frame_jitter": _flush_stat_schema(
+            unit_of_measurement="µs",
+            icon=ICON_TIMER,
+            accuracy_decimals=0,
+        ),
+        # Chunks re-sent after an integrity mismatch per interval.
+        "corrupt_chunks": _flush_stat_schema(
+            icon=ICON_COUNTER,
+            accuracy_decimals=0,
+        ),
+        # Pixel payload this display sent to its FPGA, in kB/s.
+        "throughput": _flush_stat_schema(
+            unit_of_measurement="kB/s",
+            device_class=DEVICE_CLASS_DATA_RATE,
+            accuracy_decimals=1,
+        ),
+        # Share of draw_asset() calls that found their asset cached.
+        "asset_hit_rate": _flush_stat_schema(
+            unit_of_measurement=UNIT_PERCENT,
+            icon=ICON_PERCENT,
+            accuracy_decimals=0,
+        ),
+        # Seconds spent switched on, and off, per interval.
+        "on_time": _flush_stat_schema(
+            unit_of_measurement="s",
+            device_class=DEVICE_CLASS_DURATION,
+            accuracy_decimals=0,
+        ),
+        "off_time": _flush_stat_schema(
+            unit_of_measurement="s",
+            device_class=DEVICE_CLASS_DURATION,
+            accuracy_decimals=0,
+        ),
     },
     default_type="update_duration",
 )
@@ -110,3 +260,8 @@ async def to_code(config):
 
     if config[CONF_TYPE] in STATUS_VALUE_ADDRS:
         cg.add(var.set_address(STATUS_VALUE_ADDRS[config[CONF_TYPE]]))
+    elif config[CONF_TYPE] in FLUSH_STAT_TYPES:
+        cg.add(var.set_stat_type(FLUSH_STAT_TYPES[config[CONF_TYPE]]))
+    elif config[CONF_TYPE] == "latency":
+        cg.add(var.set_phase(config[CONF_PHASE]))
+        cg.add(var.set_statistic(config[CONF_STATISTIC]))
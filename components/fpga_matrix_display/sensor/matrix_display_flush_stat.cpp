@@ -0,0 +1,94 @@
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+#include "matrix_display_flush_stat.h"
+
+namespace esphome::matrix_display::matrix_display_flush_stat {
+
+static const char *const TAG = "matrix_display.flush_stat";
+
+void MatrixDisplayFlushStat::update() {
+    if (this->display_ == nullptr)
+        return;
+    const MatrixDisplay::FlushStats now = this->display_->get_flush_stats();
+    const uint32_t render_dropped = this->display_->get_dropped_frames();
+    const uint32_t now_micros = micros();
+    const uint32_t elapsed_micros = now_micros - this->last_micros_;
+    const uint32_t frames = now.frames - this->last_.frames;
+    const bool power_time = this->stat_type_ == FlushStatType::ON_TIME ||
+                            this->stat_type_ == FlushStatType::OFF_TIME;
+    if (frames == 0 && !power_time)
+        return;
+    float value = 0.0f;
+    switch (this->stat_type_) {
+    case FlushStatType::BYTES_PER_FRAME:
+        value = static_cast<float>(now.bytes - this->last_.bytes) / frames;
+        break;
+    case FlushStatType::COMMANDS_PER_FRAME:
+        value =
+            static_cast<float>(now.commands - this->last_.commands) / frames;
+        break;
+    case FlushStatType::FLUSH_DURATION:
+        value = static_cast<float>(now.flush_micros -
+                                   this->last_.flush_micros) /
+                frames;
+        break;
+    case FlushStatType::ACHIEVED_FPS:
+        // Frames actually swapped onto the panel per second.
+        value = static_cast<float>(now.commits - this->last_.commits) * 1e6f /
+                elapsed_micros;
+        break;
+    case FlushStatType::DROPPED_FRAMES:
+        value = static_cast<float>(
+            (now.dropped - this->last_.dropped) +
+            (render_dropped - this->last_render_dropped_));
+        break;
+    case FlushStatType::FRAME_JITTER: {
+        const uint32_t samples =
+            now.jitter_samples - this->last_.jitter_samples;
+        if (samples == 0)
+            break;
+        value = static_cast<float>(now.jitter_micros -
+                                   this->last_.jitter_micros) /
+                samples;
+        break;
+    }
+    case FlushStatType::CORRUPT_CHUNKS:
+        value = static_cast<float>(now.corrupt_chunks -
+                                   this->last_.corrupt_chunks);
+        break;
+    case FlushStatType::THROUGHPUT:
+        // Pixel payload this display pushed, in kB/s (bytes per ms).
+        value = static_cast<float>(now.bytes - this->last_.bytes) * 1e3f /
+                elapsed_micros;
+        break;
+    case FlushStatType::ASSET_HIT_RATE: {
+        // Share of draw_asset() calls served from the asset cache.
+        const uint32_t hits = now.asset_hits - this->last_.asset_hits;
+        const uint32_t calls =
+            hits + (now.asset_misses - this->last_.asset_misses);
+        if (calls == 0)
+            break;
+        value = static_cast<float>(hits) * 100.0f / calls;
+        break;
+    }
+    case FlushStatType::ON_TIME:
+        value = static_cast<float>(now.on_millis - this->last_.on_millis) /
+                1000.0f;
+        break;
+    case FlushStatType::OFF_TIME:
+        value = static_cast<float>(now.off_millis - this->last_.off_millis) /
+                1000.0f;
+        break;
+    }
+    this->last_ = now;
+    this->last_render_dropped_ = render_dropped;
+    this->last_micros_ = now_micros;
+    this->publish_state(value);
+}
+
+void MatrixDisplayFlushStat::dump_config() {
+    LOG_SENSOR("", "MatrixDisplayFlushStat", this);
+    LOG_UPDATE_INTERVAL(this);
+}
+
+} // namespace esphome::matrix_display::matrix_display_flush_stat
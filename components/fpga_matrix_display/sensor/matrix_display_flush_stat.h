@@ -0,0 +1,68 @@
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+#pragma once
+
+#include "../matrix_display.h"
+#include "esphome/components/sensor/sensor.h"
+#include "esphome/core/component.h"
+
+namespace esphome::matrix_display::matrix_display_flush_stat {
+
+/// Which per-frame flush figure this sensor reports.
+enum class FlushStatType : uint8_t {
+    BYTES_PER_FRAME,
+    COMMANDS_PER_FRAME,
+    FLUSH_DURATION,
+    ACHIEVED_FPS,
+    DROPPED_FRAMES,
+    FRAME_JITTER,
+    CORRUPT_CHUNKS,
+    THROUGHPUT,
+    ASSET_HIT_RATE,
+    ON_TIME,
+    OFF_TIME,
+};
+
+/**
+ * Reports a per-frame average of one MatrixDisplay flush counter over the
+ * sensor's update_interval. Each poll diffs the display's cumulative
+ * FlushStats against the previous poll, so the figure covers exactly the
+ * frames rendered in between; nothing is published until a frame has run.
+ * The frame-pacing figures are rates and totals over the same interval. The
+ * power-state times keep publishing while the display is off and no frames
+ * run.
+ */
+class MatrixDisplayFlushStat : public sensor::Sensor, public PollingComponent {
+  public:
+    void update() override;
+
+    void dump_config() override;
+
+    /**
+     * Sets the reference to the display component this sensor measures.
+     *
+     * @param display Matrix display component reference
+     */
+    void set_display(MatrixDisplay *display) { this->display_ = display; }
+
+    /**
+     * Selects which flush figure this sensor publishes.
+     *
+     * @param type statistic selector
+     */
+    void set_stat_type(FlushStatType type) { this->stat_type_ = type; }
+
+  protected:
+    /// @brief display component this sensor measures
+    MatrixDisplay *display_{nullptr};
+    /// @brief which flush figure to publish
+    FlushStatType stat_type_{FlushStatType::BYTES_PER_FRAME};
+    /// @brief counters seen at the previous poll
+    MatrixDisplay::FlushStats last_{};
+    /// @brief render task drops seen at the previous poll
+    uint32_t last_render_dropped_{0};
+    /// @brief micros() at the previous poll, for rates
+    uint32_t last_micros_{0};
+};
+
+} // namespace esphome::matrix_display::matrix_display_flush_stat
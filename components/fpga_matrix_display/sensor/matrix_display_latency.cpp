@@ -0,0 +1,41 @@
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+#include "matrix_display_latency.h"
+
+namespace esphome::matrix_display::matrix_display_latency {
+
+static const char *const TAG = "matrix_display.latency";
+
+void MatrixDisplayLatency::update() {
+    if (this->display_ == nullptr)
+        return;
+    const LatencyHistogram &histogram = this->display_->get_latency(this->phase_);
+    if (histogram.count() == 0)
+        return;
+    uint32_t value = 0;
+    switch (this->statistic_) {
+    case LatencyStatistic::MIN:
+        value = histogram.min();
+        break;
+    case LatencyStatistic::MAX:
+        value = histogram.max();
+        break;
+    case LatencyStatistic::P50:
+        value = histogram.percentile(0.50f);
+        break;
+    case LatencyStatistic::P95:
+        value = histogram.percentile(0.95f);
+        break;
+    case LatencyStatistic::P99:
+        value = histogram.percentile(0.99f);
+        break;
+    }
+    this->publish_state(value);
+}
+
+void MatrixDisplayLatency::dump_config() {
+    LOG_SENSOR("", "MatrixDisplayLatency", this);
+    LOG_UPDATE_INTERVAL(this);
+}
+
+} // namespace esphome::matrix_display::matrix_display_latency
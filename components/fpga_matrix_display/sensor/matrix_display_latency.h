@@ -0,0 +1,63 @@
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+#pragma once
+
+#include "../matrix_display.h"
+#include "esphome/components/sensor/sensor.h"
+#include "esphome/core/component.h"
+
+namespace esphome::matrix_display::matrix_display_latency {
+
+/// Which figure of a phase's latency histogram this sensor reports.
+enum class LatencyStatistic : uint8_t {
+    MIN,
+    MAX,
+    P50,
+    P95,
+    P99,
+};
+
+/**
+ * Reports one statistic of a MatrixDisplay frame phase (render, pack, wait,
+ * transfer, swap) from the display's last completed latency window. Nothing
+ * is published while that window holds no frames.
+ */
+class MatrixDisplayLatency : public sensor::Sensor, public PollingComponent {
+  public:
+    void update() override;
+
+    void dump_config() override;
+
+    /**
+     * Sets the reference to the display component this sensor measures.
+     *
+     * @param display Matrix display component reference
+     */
+    void set_display(MatrixDisplay *display) { this->display_ = display; }
+
+    /**
+     * Selects the frame phase to report on.
+     *
+     * @param phase frame phase
+     */
+    void set_phase(LatencyPhase phase) { this->phase_ = phase; }
+
+    /**
+     * Selects which figure of the phase's histogram is published.
+     *
+     * @param statistic statistic selector
+     */
+    void set_statistic(LatencyStatistic statistic) {
+        this->statistic_ = statistic;
+    }
+
+  protected:
+    /// @brief display component this sensor measures
+    MatrixDisplay *display_{nullptr};
+    /// @brief frame phase to report on
+    LatencyPhase phase_{LatencyPhase::RENDER};
+    /// @brief which histogram figure to publish
+    LatencyStatistic statistic_{LatencyStatistic::P95};
+};
+
+} // namespace esphome::matrix_display::matrix_display_latency
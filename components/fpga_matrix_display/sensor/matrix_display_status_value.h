@@ -9,8 +9,9 @@
 namespace esphome::matrix_display::matrix_display_status_value {
 
 /**
- * Polls one numeric FPGA status register over the status SPI at the
- * configured update_interval and publishes its value. When the read fails
+ * Publishes one numeric FPGA status register at the configured
+ * update_interval, from the display's status poller snapshot (or a direct
+ * status SPI read when the poller is off). When the read fails
  * (status bus not configured, FPGA in reset, no fresh frame) nothing is
  * published, so the last known state is retained; the failure detail is
  * logged by MatrixDisplay.
@@ -27,6 +28,11 @@ class MatrixDisplayStatusValue : public sensor::Sensor,
         this->publish_state(static_cast<float>(value));
     }
 
+    void setup() override {
+        if (this->display_ != nullptr)
+            this->display_->request_status(this->address_);
+    }
+
     void dump_config() override;
 
     /**
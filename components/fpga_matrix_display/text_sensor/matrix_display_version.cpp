@@ -6,6 +6,12 @@ namespace esphome::matrix_display::matrix_display_version {
 
 static const char *const TAG = "matrix_display.version";
 
+void MatrixDisplayVersion::setup() {
+    if (this->display_ != nullptr)
+        this->display_->request_status(
+            MatrixPanel_FPGA_SPI::STATUS_ADDR_VERSION);
+}
+
 void MatrixDisplayVersion::update() {
     if (this->display_ == nullptr)
         return;
@@ -9,8 +9,8 @@
 namespace esphome::matrix_display::matrix_display_version {
 
 /**
- * Polls the FPGA gateware version register (STATUS_ADDR_VERSION) at the
- * configured update_interval and publishes it as a formatted string, e.g.
+ * Publishes the FPGA gateware version register (STATUS_ADDR_VERSION) at the
+ * configured update_interval as a formatted string, e.g.
  * "v1.2.3+45.sha1a2b3c4d-dirty". The library owns the decoding and formatting
  * (MatrixPanel_FPGA_SPI::readVersion / formatVersion). When the read fails
  * (status bus not configured, FPGA in reset, no fresh frame) nothing is
@@ -20,6 +20,8 @@ namespace esphome::matrix_display::matrix_display_version {
 class MatrixDisplayVersion : public text_sensor::TextSensor,
                              public PollingComponent {
   public:
+    void setup() override;
+
     void update() override;
 
     void dump_config() override;
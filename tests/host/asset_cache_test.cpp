@@ -0,0 +1,188 @@
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+// Asset cache: hits and misses are counted, the least recently drawn or
+// cached asset is evicted when the budget runs out, a replacement that cannot be
+// allocated leaves the old copy in place, and drawn assets land in the
+// framebuffer in every pixel format. With a render task, the cache and the
+// bulk drawing calls refuse any other task.
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "host_display.h"
+
+using namespace host;
+using esphome::matrix_display::PixelFormat;
+
+namespace {
+
+constexpr int kSize = 8;
+
+/// @brief a solid big-endian RGB888 image
+std::vector<uint8_t> solid(uint8_t r, uint8_t g, uint8_t b) {
+    std::vector<uint8_t> image;
+    for (int i = 0; i < kSize * kSize; ++i)
+        image.insert(image.end(), {r, g, b});
+    return image;
+}
+
+bool cache(HostDisplay &display, uint16_t id, const std::vector<uint8_t> &image) {
+    return display.cache_asset(id, kSize, kSize, image.data(),
+                               esphome::display::COLOR_ORDER_RGB,
+                               esphome::display::COLOR_BITNESS_888, true);
+}
+
+/// @brief whether the asset's rect at (x, y) holds @p image's colour, give
+/// or take what the framebuffer's format rounds off
+bool holds(HostDisplay &display, int x, int y,
+           const std::vector<uint8_t> &image) {
+    for (int row = 0; row < kSize; ++row) {
+        for (int col = 0; col < kSize; ++col) {
+            uint8_t rgb[3];
+            display.expected_rgb(x + col, y + row, rgb);
+            for (int c = 0; c < 3; ++c) {
+                if (std::abs(rgb[c] - image[static_cast<size_t>(c)]) > 17)
+                    return false;
+            }
+        }
+    }
+    return true;
+}
+
+void run(PixelFormat format) {
+    HostDisplay display(32, 16, 2);
+    display.set_pixel_format(format);
+    const size_t asset_bytes =
+        format == PixelFormat::RGB565 ? kSize * kSize * 2
+        : format == PixelFormat::RGB444 ? kSize * kSize * 3 / 2
+                                        : kSize * kSize * 3;
+    // Room for three assets.
+    display.set_asset_cache_bytes(asset_bytes * 3 + asset_bytes / 2);
+    display.setup();
+    HOST_CHECK(!display.is_failed());
+    const auto red = solid(255, 0, 0), green = solid(0, 255, 0),
+               blue = solid(0, 0, 255), white = solid(255, 255, 255),
+               grey = solid(96, 96, 96);
+
+    // Misses before caching, hits after.
+    HOST_CHECK(!display.draw_asset(1, 0, 0));
+    HOST_CHECK(cache(display, 1, red));
+    HOST_CHECK(cache(display, 2, green));
+    HOST_CHECK(cache(display, 3, blue));
+    HOST_CHECK(display.draw_asset(1, 0, 0));
+    HOST_CHECK(display.draw_asset(2, 8, 0));
+    HOST_CHECK(display.draw_asset(3, 16, 0));
+    auto stats = display.get_flush_stats();
+    HOST_CHECK(stats.asset_hits == 3 && stats.asset_misses == 1);
+
+    // Asset 1 is now the least recently drawn; redraw it so 2 is.
+    HOST_CHECK(display.draw_asset(1, 0, 8));
+    HOST_CHECK(cache(display, 4, white));
+    HOST_CHECK(!display.draw_asset(2, 8, 0));
+    HOST_CHECK(display.draw_asset(1, 0, 0));
+    HOST_CHECK(display.draw_asset(3, 16, 0));
+    HOST_CHECK(display.draw_asset(4, 24, 0));
+
+    // A replacement that cannot be allocated keeps the old copy.
+    host::fail_allocations_after(0);
+    HOST_CHECK(!cache(display, 1, grey));
+    host::fail_allocations_after(-1);
+    HOST_CHECK(display.draw_asset(1, 0, 8));
+    HOST_CHECK(holds(display, 0, 8, red));
+    // A successful one replaces it in place, evicting nothing else.
+    HOST_CHECK(cache(display, 1, grey));
+    HOST_CHECK(display.draw_asset(1, 0, 8));
+    HOST_CHECK(holds(display, 0, 8, grey));
+    HOST_CHECK(display.draw_asset(3, 16, 0));
+    HOST_CHECK(display.draw_asset(4, 24, 0));
+
+    // Larger than the whole budget: refused.
+    std::vector<uint8_t> big(32 * 16 * 3, 0x40);
+    HOST_CHECK(!display.cache_asset(9, 32, 16, big.data(),
+                                    esphome::display::COLOR_ORDER_RGB,
+                                    esphome::display::COLOR_BITNESS_888, true));
+
+    HOST_CHECK(holds(display, 16, 0, blue));
+    HOST_CHECK(holds(display, 24, 0, white));
+    display.frame();
+    HOST_CHECK(count_mismatches(display) == 0);
+    stats = display.get_flush_stats();
+    std::printf("format %d: %u hits, %u misses\n", static_cast<int>(format),
+                static_cast<unsigned>(stats.asset_hits),
+                static_cast<unsigned>(stats.asset_misses));
+}
+
+/// @brief a newly cached asset counts as used after every earlier draw, so
+/// the asset drawn just before it is evicted first
+void run_lru_order() {
+    HostDisplay display(32, 16, 2);
+    // Room for four RGB888 assets.
+    display.set_asset_cache_bytes(kSize * kSize * 3 * 4 + kSize * kSize);
+    display.setup();
+    HOST_CHECK(!display.is_failed());
+    const auto red = solid(255, 0, 0);
+    HOST_CHECK(cache(display, 1, red));
+    HOST_CHECK(cache(display, 2, red));
+    HOST_CHECK(cache(display, 3, red));
+    HOST_CHECK(display.draw_asset(3, 0, 0));
+    HOST_CHECK(cache(display, 4, red));
+    HOST_CHECK(display.draw_asset(2, 0, 0));
+    // Evicts 1, and its slot goes to 4, ahead of 3.
+    HOST_CHECK(cache(display, 5, red));
+    // 3 was drawn before 4 was cached: 3 goes, 4 stays.
+    HOST_CHECK(cache(display, 6, red));
+    HOST_CHECK(!display.draw_asset(3, 0, 0));
+    HOST_CHECK(display.draw_asset(4, 0, 0));
+    HOST_CHECK(display.draw_asset(2, 0, 0));
+    HOST_CHECK(display.draw_asset(5, 0, 0));
+    HOST_CHECK(display.draw_asset(6, 0, 0));
+}
+
+/// @brief a display whose framebuffer is owned by a render task; the
+/// harness cannot run one, so only its handle is set
+class RenderOwnedDisplay : public HostDisplay {
+  public:
+    using HostDisplay::HostDisplay;
+    void set_render_task(void *task) { this->render_task_handle_ = task; }
+};
+
+void run_foreign_task() {
+    static int render_task;
+    RenderOwnedDisplay display(32, 16, 2);
+    display.setup();
+    HOST_CHECK(!display.is_failed());
+    const auto red = solid(255, 0, 0);
+    display.set_render_task(&render_task);
+
+    // Called from the main loop: refused, nothing drawn or counted.
+    HOST_CHECK(!cache(display, 1, red));
+    HOST_CHECK(!display.draw_asset(1, 0, 0));
+    display.fill_rect(0, 0, 8, 8, Color(255, 0, 0));
+    uint8_t rgb[3];
+    display.expected_rgb(0, 0, rgb);
+    HOST_CHECK(rgb[0] == 0);
+    auto stats = display.get_flush_stats();
+    HOST_CHECK(stats.asset_hits == 0 && stats.asset_misses == 0);
+
+    // Called from the render task itself: served.
+    host::set_current_task(&render_task);
+    HOST_CHECK(cache(display, 1, red));
+    HOST_CHECK(display.draw_asset(1, 0, 0));
+    HOST_CHECK(holds(display, 0, 0, red));
+    host::set_current_task(nullptr);
+    stats = display.get_flush_stats();
+    HOST_CHECK(stats.asset_hits == 1 && stats.asset_misses == 0);
+    display.set_render_task(nullptr);
+}
+
+} // namespace
+
+int main() {
+    run_foreign_task();
+    run_lru_order();
+    for (PixelFormat format :
+         {PixelFormat::RGB888, PixelFormat::RGB565, PixelFormat::RGB444})
+        run(format);
+    std::printf("asset cache OK\n");
+    return 0;
+}
@@ -0,0 +1,100 @@
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+// SPI calibration runs from loop() in short slices: setup() returns at once,
+// no loop() call holds the main loop for long, frames wait until it settles
+// one step below the fastest clean clock, and the panel then shows the
+// framebuffer. A reboot reuses the stored clock without probing. A later
+// restart waits for the transfers in flight before the driver goes.
+#include <cstdio>
+
+#include "host_display.h"
+
+using namespace host;
+
+/// @brief longest a single call may take on the simulated clock: one slice
+/// plus the rect in flight when it ends
+static constexpr uint64_t kMaxCallUs = 30000;
+
+class RestartDisplay : public HostDisplay {
+  public:
+    using HostDisplay::HostDisplay;
+    bool restart(FPGA_SPI_CFG::clk_speed speed) {
+        return this->restart_panel_(speed);
+    }
+};
+
+int main() {
+    FpgaSimModel &model = MatrixPanel_FPGA_SPI::sim_model();
+    model.max_clean_hz = 26000000;
+    esphome::global_preferences->reset();
+
+    RestartDisplay display(64, 32, 2, FPGA_SPI_CFG::HZ_10M);
+    display.set_spi_calibration(true);
+    uint32_t renders = 0;
+    display.set_writer([&](esphome::display::Display &it) {
+        renders++;
+        it.fill(Color(0, 0, 0));
+        it.filled_rectangle(10, 4, 20, 12, Color(200, 40, 90));
+    });
+    uint64_t start = host::now_us();
+    display.setup();
+    HOST_CHECK(!display.is_failed());
+    HOST_CHECK(host::now_us() - start < kMaxCallUs);
+    HOST_CHECK(display.is_calibrating());
+
+    // The main loop keeps turning while the probes run; update() is due
+    // every 16 ms but draws nothing until calibration is done.
+    uint64_t longest = 0;
+    uint32_t calls = 0;
+    uint64_t next_update = host::now_us();
+    start = host::now_us();
+    while (display.is_calibrating()) {
+        HOST_CHECK(host::now_us() - start < 60000000ull);
+        const uint64_t call_start = host::now_us();
+        if (host::now_us() >= next_update) {
+            display.update();
+            next_update += 16000;
+        } else {
+            display.loop();
+        }
+        longest = std::max(longest, host::now_us() - call_start);
+        calls++;
+        host::advance_us(1000);
+    }
+    std::printf("calibration: %.1f s over %u calls, longest call %.1f ms\n",
+                (host::now_us() - start) / 1e6, calls, longest / 1e3);
+    HOST_CHECK(longest <= kMaxCallUs);
+    HOST_CHECK(renders == 0);
+    // 26 MHz is the fastest clean clock; one step below it is 20 MHz.
+    HOST_CHECK(display.spispeed() == FPGA_SPI_CFG::HZ_20M);
+
+    display.frame();
+    HOST_CHECK(renders == 1);
+    HOST_CHECK(count_mismatches(display) == 0);
+
+    // A step-down with a full-chain rect still on the wire: the stand-in
+    // aborts if the driver goes before it lands.
+    static uint8_t payload[128 * 32 * 3];
+    display.fpga().drawRectRGB888_prealloc(0, 0, 128, 32, payload,
+                                           sizeof(payload));
+    HOST_CHECK(!display.fpga().worker_is_idle());
+    HOST_CHECK(display.restart(FPGA_SPI_CFG::HZ_15M));
+    HOST_CHECK(display.spispeed() == FPGA_SPI_CFG::HZ_15M);
+    display.frame();
+    HOST_CHECK(count_mismatches(display) == 0);
+
+    // A reboot loads the stored clock and does not calibrate again.
+    HostDisplay rebooted(64, 32, 2, FPGA_SPI_CFG::HZ_10M);
+    rebooted.set_spi_calibration(true);
+    rebooted.setup();
+    HOST_CHECK(!rebooted.is_calibrating());
+    HOST_CHECK(rebooted.spispeed() == FPGA_SPI_CFG::HZ_20M);
+    // Another display keeps its own slot.
+    HostDisplay second(64, 32, 2, FPGA_SPI_CFG::HZ_10M);
+    second.set_spi_calibration(true);
+    second.set_instance_index(1);
+    second.setup();
+    HOST_CHECK(second.is_calibrating());
+    std::printf("calibration OK\n");
+    return 0;
+}
@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+// Chunk width microbenchmark: link time per frame of each workload at every
+// chunk_width, with row-major and tiled framebuffers. Narrow chunks send
+// fewer unchanged pixels; wide ones issue fewer commands, which matters most
+// where runs cannot be merged (tiled). Width 0 is auto; the width it picked
+// is shown alongside.
+//
+// Usage: chunk_width_bench [frames]
+#include <cstdio>
+#include <cstdlib>
+
+#include "host_display.h"
+#include "workloads.h"
+
+using namespace host;
+
+/// @return link time per frame, in microseconds
+static double run(int chunk_width, bool tiled, Workload workload,
+                  uint32_t frames, double &commands, int &picked) {
+    HostDisplay display(64, 32, 2, FPGA_SPI_CFG::HZ_26M);
+    display.set_auto_clear(false);
+    display.set_chunk_width(chunk_width);
+    display.set_tiled_framebuffer(tiled);
+    uint32_t frame = 0;
+    display.set_writer([&](esphome::display::Display &) {
+        run_workload(display, workload, frame);
+    });
+    display.setup();
+    picked = display.chunk_width();
+    display.frame();
+    const auto stats_before = display.get_flush_stats();
+    const auto fpga_before = display.fpga().sim_stats();
+    for (frame = 1; frame <= frames; ++frame) {
+        host::advance_us(16000);
+        display.frame();
+        HOST_CHECK(count_mismatches(display) == 0);
+    }
+    commands = double(display.get_flush_stats().commands -
+                      stats_before.commands) /
+               frames;
+    return double(display.fpga().sim_stats().link_us - fpga_before.link_us) /
+           frames;
+}
+
+int main(int argc, char **argv) {
+    const uint32_t frames = argc > 1 ? std::atoi(argv[1]) : 120;
+    const Workload workloads[] = {Workload::FULL, Workload::SPARSE,
+                                  Workload::MARQUEE, Workload::ICONS,
+                                  Workload::SCROLL};
+    std::printf("128x32 chain at 26 MHz; link us (commands) per frame\n");
+    for (bool tiled : {false, true}) {
+        std::printf("\n%-6s %8s", tiled ? "tiled" : "rows", "width");
+        for (Workload workload : workloads)
+            std::printf(" %17s", workload_name(workload));
+        std::printf("\n");
+        for (int width : {4, 8, 16, 32, 64, 0}) {
+            double links[5];
+            double commands[5];
+            int picked = 0;
+            for (size_t i = 0; i < 5; ++i)
+                links[i] = run(width, tiled, workloads[i], frames,
+                               commands[i], picked);
+            char label[16];
+            if (width != 0)
+                std::snprintf(label, sizeof(label), "%d", width);
+            else
+                std::snprintf(label, sizeof(label), "auto(%d)", picked);
+            std::printf("%-6s %8s", "", label);
+            for (size_t i = 0; i < 5; ++i)
+                std::printf(" %9.0f (%5.1f)", links[i], commands[i]);
+            std::printf("\n");
+            HOST_CHECK(picked >= 4 && picked <= 64);
+        }
+    }
+    return 0;
+}
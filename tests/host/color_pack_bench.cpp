@@ -0,0 +1,124 @@
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+// Colour correction pack microbenchmark: host CPU time to expand one full
+// RGB888 frame for the FPGA with the plain memcpy, with the colour tables
+// (color_correction), and with a word-at-a-time variant of the table lookup
+// kept here for comparison. Host timings only rank the variants; absolute
+// numbers on an ESP32 differ.
+//
+// Usage: color_pack_bench [iterations]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "host_display.h"
+
+using namespace host;
+
+namespace {
+
+class BenchDisplay : public HostDisplay {
+  public:
+    using HostDisplay::HostDisplay;
+
+    /// @brief expands every framebuffer row into @p dst as the flush does
+    void pack_frame(uint8_t *dst) const {
+        const int width = this->cached_width_;
+        for (int y = 0; y < this->cached_height_; ++y) {
+            this->expand_row_(dst, this->buffer_ + this->fb_bytes_(this->pixel_index_(0, y)),
+                              width);
+            dst += static_cast<size_t>(width) * 3;
+        }
+    }
+    const uint8_t (*color_lut() const)[256] { return this->color_lut_; }
+};
+
+/// Four RGB888 pixels are three whole words; looks each byte up with its
+/// lane's channel fixed and reassembles the words.
+void map_rgb888_words(uint8_t *dst, const uint8_t *src, size_t bytes,
+                      const uint8_t (*lut)[256]) {
+    const uint8_t *r = lut[0];
+    const uint8_t *g = lut[1];
+    const uint8_t *b = lut[2];
+    size_t i = 0;
+    for (; i + 12 <= bytes; i += 12) {
+        uint32_t in[3];
+        std::memcpy(in, src + i, sizeof(in));
+        const uint32_t out[3] = {
+            r[in[0] & 0xFF] | g[(in[0] >> 8) & 0xFF] << 8 |
+                b[(in[0] >> 16) & 0xFF] << 16 |
+                static_cast<uint32_t>(r[in[0] >> 24]) << 24,
+            g[in[1] & 0xFF] | b[(in[1] >> 8) & 0xFF] << 8 |
+                r[(in[1] >> 16) & 0xFF] << 16 |
+                static_cast<uint32_t>(g[in[1] >> 24]) << 24,
+            b[in[2] & 0xFF] | r[(in[2] >> 8) & 0xFF] << 8 |
+                g[(in[2] >> 16) & 0xFF] << 16 |
+                static_cast<uint32_t>(b[in[2] >> 24]) << 24,
+        };
+        std::memcpy(dst + i, out, sizeof(out));
+    }
+    for (; i < bytes; i += 3) {
+        dst[i] = r[src[i]];
+        dst[i + 1] = g[src[i + 1]];
+        dst[i + 2] = b[src[i + 2]];
+    }
+}
+
+/// @return nanoseconds per call of @p pack
+template <typename F> double time_ns(uint32_t iterations, F pack) {
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; ++i)
+        pack();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() /
+           iterations;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const uint32_t iterations = argc > 1 ? std::atoi(argv[1]) : 2000;
+    BenchDisplay plain(64, 32, 2), corrected(64, 32, 2);
+    uint32_t seed = 5;
+    auto writer = [&seed](esphome::display::Display &it) {
+        for (int y = 0; y < it.get_height(); ++y) {
+            for (int x = 0; x < it.get_width(); ++x) {
+                seed = seed * 1103515245u + 12345u;
+                it.draw_pixel_at(x, y, Color(seed >> 24, seed >> 16, seed >> 8));
+            }
+        }
+    };
+    for (BenchDisplay *display : {&plain, &corrected}) {
+        display->set_writer(writer);
+        display->setup();
+        HOST_CHECK(!display->is_failed());
+    }
+    corrected.set_color_correction(2.2f, 1.0f, 0.8f, 0.6f);
+    plain.frame();
+    seed = 5;
+    corrected.frame();
+    HOST_CHECK(count_mismatches(corrected) == 0);
+
+    const size_t bytes = static_cast<size_t>(plain.width()) * plain.height() * 3;
+    std::vector<uint8_t> expected(bytes), packed(bytes), words(bytes);
+    corrected.pack_frame(expected.data());
+    const double memcpy_ns =
+        time_ns(iterations, [&]() { plain.pack_frame(packed.data()); });
+    const double lut_ns =
+        time_ns(iterations, [&]() { corrected.pack_frame(packed.data()); });
+    const double words_ns = time_ns(iterations, [&]() {
+        map_rgb888_words(words.data(), plain.framebuffer(), bytes,
+                         corrected.color_lut());
+    });
+    HOST_CHECK(packed == expected);
+    HOST_CHECK(words == expected);
+    std::printf("%dx%d RGB888 frame; ns per full pack\n", plain.width(),
+                plain.height());
+    std::printf("%-22s %10.0f\n", "memcpy", memcpy_ns);
+    std::printf("%-22s %10.0f (%.1fx memcpy)\n", "tables, per byte", lut_ns,
+                lut_ns / memcpy_ns);
+    std::printf("%-22s %10.0f (%.1fx memcpy)\n", "tables, word at a time",
+                words_ns, words_ns / memcpy_ns);
+    return 0;
+}
@@ -0,0 +1,128 @@
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+// compress_rects round trip: random content made of single-colour row bands,
+// with noisy chunks mixed in, must reach the panel unchanged in every pixel
+// format, using fills where they are cheaper and fewer wire bytes than the
+// raw uploads. The marquee workload (text scrolling over black) must come
+// out unchanged too, in less link time than raw. Also checks the measured
+// per-command cost against the stand-in's timing model.
+//
+// Usage: compress_rects_test [frames]
+#include <cstdio>
+#include <cstdlib>
+
+#include "host_display.h"
+#include "workloads.h"
+
+using namespace host;
+using esphome::matrix_display::PixelFormat;
+
+/// @brief per-command cost of the stand-in, in payload bytes at @p hz
+static double model_overhead_bytes(double hz) {
+    const FpgaSimModel &model = MatrixPanel_FPGA_SPI::sim_model();
+    const double us_per_byte = 8e6 / hz;
+    return (model.command_latency_us + model.busy_us) / us_per_byte +
+           MatrixPanel_FPGA_SPI::kRectHeaderBytes;
+}
+
+/// @brief paints bands of 8-16 rows in random colours, then overwrites a few
+/// random rects pixel by pixel
+static void draw_bands(esphome::display::Display &it, uint32_t &seed) {
+    auto next = [&seed]() {
+        seed = seed * 1103515245u + 12345u;
+        return seed >> 8;
+    };
+    for (int y = 0; y < it.get_height();) {
+        const int rows = 8 + next() % 9;
+        it.filled_rectangle(0, y, it.get_width(), rows,
+                            Color(next() & 0xFF, next() & 0xFF, next() & 0xFF));
+        y += rows;
+    }
+    const int noisy = next() % 4;
+    for (int i = 0; i < noisy; ++i) {
+        const int x0 = next() % it.get_width();
+        const int y0 = next() % it.get_height();
+        for (int y = y0; y < std::min(y0 + 6, it.get_height()); ++y)
+            for (int x = x0; x < std::min(x0 + 6, it.get_width()); ++x)
+                it.draw_pixel_at(x, y, Color(next() & 0xFF, next() & 0xFF,
+                                             next() & 0xFF));
+    }
+}
+
+struct RunStats {
+    uint64_t wire_bytes;
+    uint64_t link_us;
+    uint64_t fills;
+};
+
+/// @brief sends @p frames frames of draw_bands(), or of the marquee workload
+static RunStats run(PixelFormat format, bool compress, bool marquee,
+                    uint32_t frames) {
+    HostDisplay display(64, 32, 2, FPGA_SPI_CFG::HZ_26M);
+    display.set_auto_clear(false);
+    display.set_pixel_format(format);
+    display.set_compress_rects(compress);
+    uint32_t seed = 1;
+    uint32_t frame = 0;
+    display.set_writer([&](esphome::display::Display &it) {
+        if (marquee)
+            run_workload(display, Workload::MARQUEE, frame++);
+        else
+            draw_bands(it, seed);
+    });
+    display.setup();
+    HOST_CHECK(!display.is_failed());
+    const double expected = model_overhead_bytes(26e6);
+    const double measured = display.command_overhead_bytes();
+    if (measured < expected * 0.9 || measured > expected * 1.1) {
+        std::fprintf(stderr, "command overhead %.0f bytes, model %.0f\n",
+                     measured, expected);
+        std::exit(1);
+    }
+    display.frame();
+    const auto before = display.fpga().sim_stats();
+    for (uint32_t i = 0; i < frames; ++i) {
+        host::advance_us(16000);
+        display.frame();
+        HOST_CHECK(count_mismatches(display) == 0);
+    }
+    const auto after = display.fpga().sim_stats();
+    HOST_CHECK(after.out_of_bounds == 0);
+    return {after.wire_bytes - before.wire_bytes,
+            after.link_us - before.link_us, after.fills - before.fills};
+}
+
+int main(int argc, char **argv) {
+    const uint32_t frames = argc > 1 ? std::atoi(argv[1]) : 60;
+    const struct {
+        PixelFormat format;
+        const char *name;
+    } formats[] = {{PixelFormat::RGB888, "rgb888"},
+                   {PixelFormat::RGB565, "rgb565"},
+                   {PixelFormat::RGB444, "rgb444"}};
+    std::printf("%-7s %12s %12s %8s\n", "format", "raw B", "compressed B",
+                "fills");
+    for (const auto &entry : formats) {
+        const RunStats raw = run(entry.format, false, false, frames);
+        const RunStats compressed = run(entry.format, true, false, frames);
+        std::printf("%-7s %12llu %12llu %8llu\n", entry.name,
+                    static_cast<unsigned long long>(raw.wire_bytes),
+                    static_cast<unsigned long long>(compressed.wire_bytes),
+                    static_cast<unsigned long long>(compressed.fills));
+        HOST_CHECK(raw.fills == 0);
+        HOST_CHECK(compressed.fills > 0);
+        HOST_CHECK(compressed.wire_bytes < raw.wire_bytes);
+    }
+    // Text breaks up the rows it crosses; the black either side of it still
+    // goes out as fills.
+    const RunStats raw = run(PixelFormat::RGB888, false, true, frames);
+    const RunStats compressed = run(PixelFormat::RGB888, true, true, frames);
+    std::printf("marquee: raw %llu us, compressed %llu us, %llu fills\n",
+                static_cast<unsigned long long>(raw.link_us),
+                static_cast<unsigned long long>(compressed.link_us),
+                static_cast<unsigned long long>(compressed.fills));
+    HOST_CHECK(compressed.fills > 0);
+    HOST_CHECK(compressed.link_us < raw.link_us);
+    std::printf("compress_rects round trip OK\n");
+    return 0;
+}
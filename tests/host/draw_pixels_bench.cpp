@@ -0,0 +1,115 @@
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+// draw_pixels_at microbenchmark: host CPU time of the bulk override against
+// the per-pixel Display base it replaces, for the source/framebuffer format
+// pairs images commonly hit. Both paths must leave identical framebuffers.
+// Host timings only rank the two paths; absolute numbers on an ESP32 differ.
+//
+// Usage: draw_pixels_bench [iterations]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "host_display.h"
+
+using namespace host;
+using esphome::display::ColorBitness;
+using esphome::display::ColorOrder;
+using esphome::matrix_display::PixelFormat;
+
+namespace {
+
+class BenchDisplay : public HostDisplay {
+  public:
+    using HostDisplay::HostDisplay;
+
+    /// @brief the per-pixel path the component falls back to
+    void base_draw_pixels_at(int x, int y, int w, int h, const uint8_t *ptr,
+                             ColorOrder order, ColorBitness bitness,
+                             bool big_endian) {
+        esphome::display::Display::draw_pixels_at(x, y, w, h, ptr, order,
+                                                  bitness, big_endian, 0, 0, 0);
+    }
+    size_t framebuffer_bytes() const {
+        return this->fb_bytes_(static_cast<size_t>(this->cached_width_) *
+                               this->cached_height_);
+    }
+};
+
+struct Case {
+    const char *name;
+    PixelFormat format;
+    bool tiled;
+    ColorBitness bitness;
+    bool big_endian;
+};
+
+constexpr int kImageWidth = 48;
+constexpr int kImageHeight = 24;
+
+/// @return nanoseconds per call of @p draw
+template <typename F> double time_ns(uint32_t iterations, F draw) {
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; ++i)
+        draw(i);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() /
+           iterations;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const uint32_t iterations = argc > 1 ? std::atoi(argv[1]) : 2000;
+    const Case cases[] = {
+        {"888 -> rgb888", PixelFormat::RGB888, false,
+         esphome::display::COLOR_BITNESS_888, true},
+        {"565 -> rgb565", PixelFormat::RGB565, false,
+         esphome::display::COLOR_BITNESS_565, false},
+        {"565 -> rgb888", PixelFormat::RGB888, false,
+         esphome::display::COLOR_BITNESS_565, false},
+        {"888 -> rgb444", PixelFormat::RGB444, false,
+         esphome::display::COLOR_BITNESS_888, true},
+        {"888 -> tiled", PixelFormat::RGB888, true,
+         esphome::display::COLOR_BITNESS_888, true},
+    };
+    std::vector<uint8_t> image(kImageWidth * kImageHeight * 3);
+    uint32_t seed = 7;
+    for (uint8_t &byte : image) {
+        seed = seed * 1103515245u + 12345u;
+        byte = seed >> 16;
+    }
+    std::printf("%dx%d image on a 128x32 chain; ns per call\n", kImageWidth,
+                kImageHeight);
+    std::printf("%-14s %12s %12s %8s\n", "case", "per-pixel", "bulk",
+                "speedup");
+    for (const Case &c : cases) {
+        BenchDisplay bulk(64, 32, 2), base(64, 32, 2);
+        for (BenchDisplay *display : {&bulk, &base}) {
+            display->set_pixel_format(c.format);
+            display->set_tiled_framebuffer(c.tiled);
+            display->setup();
+            HOST_CHECK(!display->is_failed());
+        }
+        // Odd offsets that walk across chunk edges and off the right side.
+        auto x_at = [](uint32_t i) { return static_cast<int>(i * 7 % 96) - 5; };
+        auto y_at = [](uint32_t i) { return static_cast<int>(i * 3 % 16) - 2; };
+        const double base_ns = time_ns(iterations, [&](uint32_t i) {
+            base.base_draw_pixels_at(x_at(i), y_at(i), kImageWidth,
+                                     kImageHeight, image.data(),
+                                     esphome::display::COLOR_ORDER_RGB,
+                                     c.bitness, c.big_endian);
+        });
+        const double bulk_ns = time_ns(iterations, [&](uint32_t i) {
+            bulk.draw_pixels_at(x_at(i), y_at(i), kImageWidth, kImageHeight,
+                                image.data(), esphome::display::COLOR_ORDER_RGB,
+                                c.bitness, c.big_endian, 0, 0, 0);
+        });
+        HOST_CHECK(std::memcmp(bulk.framebuffer(), base.framebuffer(),
+                               bulk.framebuffer_bytes()) == 0);
+        std::printf("%-14s %12.0f %12.0f %7.1fx\n", c.name, base_ns, bulk_ns,
+                    base_ns / bulk_ns);
+    }
+    return 0;
+}
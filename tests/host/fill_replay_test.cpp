@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+// Fill replay under a flush budget: a fill_rect() recorded while a budgeted
+// pass is still sending has missed that pass's replay, and must go out with
+// the next pass even when nothing else is drawn. The replay itself is held
+// to the budget too, so a frame of fills spreads over several calls.
+#include <cstdio>
+
+#include "host_display.h"
+
+using namespace host;
+
+static void run_mid_pass() {
+    HostDisplay display(64, 32, 2, FPGA_SPI_CFG::HZ_26M);
+    display.set_auto_clear(false);
+    display.set_flush_budget_us(200);
+    uint32_t renders = 0;
+    display.set_writer([&](esphome::display::Display &it) {
+        // Only the first frame draws; later frames leave the buffer alone.
+        if (renders++ == 0)
+            it.fill(Color(20, 60, 120));
+    });
+    display.setup();
+    HOST_CHECK(!display.is_failed());
+    display.frame();
+    HOST_CHECK(count_mismatches(display) == 0);
+
+    // A full redraw does not fit one 200 us call.
+    display.set_writer([&](esphome::display::Display &it) {
+        if (renders++ == 1)
+            it.filled_rectangle(0, 0, display.width(), display.height(),
+                                Color(200, 40, 90));
+    });
+    host::advance_us(16000);
+    display.update();
+    HOST_CHECK(!display.flush_idle());
+    // Drawn outside the writer, after the pass replayed its fills.
+    display.fill_rect(2, 3, 8, 6, Color(250, 250, 0));
+    while (!display.flush_idle()) {
+        host::advance_us(100);
+        display.loop();
+    }
+    display.drain();
+
+    host::advance_us(16000);
+    display.frame();
+    const int mismatches = count_mismatches(display);
+    std::printf("fill replay: %d mismatched pixels after the next pass\n",
+                mismatches);
+    HOST_CHECK(mismatches == 0);
+}
+
+static void run_bounded_replay() {
+    constexpr uint32_t kBudgetUs = 60;
+    HostDisplay display(64, 32, 2, FPGA_SPI_CFG::HZ_26M);
+    display.set_auto_clear(false);
+    display.set_flush_budget_us(kBudgetUs);
+    display.setup();
+    HOST_CHECK(!display.is_failed());
+    display.frame();
+
+    // Eight separate fills take several budgets to replay without a worker.
+    display.fpga().enable_worker(false);
+    display.set_writer([&](esphome::display::Display &) {
+        for (int i = 0; i < 8; ++i)
+            display.fill_rect(i * 12, 4, 8, 8, Color(30 * i, 255 - 30 * i, 90));
+    });
+    host::advance_us(16000);
+    const uint64_t start = host::now_us();
+    display.update();
+    const uint64_t first_call_us = host::now_us() - start;
+    std::printf("fill replay: first call took %llu us against a %u us "
+                "budget\n",
+                static_cast<unsigned long long>(first_call_us),
+                static_cast<unsigned>(kBudgetUs));
+    // One fill may start just before the deadline.
+    HOST_CHECK(first_call_us < 2 * kBudgetUs);
+    HOST_CHECK(!display.flush_idle());
+    while (!display.flush_idle()) {
+        host::advance_us(100);
+        display.loop();
+    }
+    display.drain();
+    HOST_CHECK(count_mismatches(display) == 0);
+}
+
+int main() {
+    run_mid_pass();
+    run_bounded_replay();
+    return 0;
+}
@@ -0,0 +1,62 @@
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+// Flush-path benchmark on the simulated FPGA: runs the bench.yaml workloads
+// at several SPI clocks and reports per-frame payload, commands, link time
+// and flush time. Every committed frame is checked against the framebuffer.
+//
+// Usage: flush_bench [frames]
+#include <cstdio>
+#include <cstdlib>
+
+#include "host_display.h"
+#include "workloads.h"
+
+using namespace host;
+
+static void run(FPGA_SPI_CFG::clk_speed speed, Workload workload,
+                uint32_t frames) {
+    HostDisplay display(64, 32, 2, speed);
+    display.set_auto_clear(false);
+    uint32_t frame = 0;
+    display.set_writer([&](esphome::display::Display &) {
+        run_workload(display, workload, frame);
+    });
+    display.setup();
+    // Settle: the first frame uploads the whole panel.
+    display.frame();
+
+    const auto stats_before = display.get_flush_stats();
+    const auto fpga_before = display.fpga().sim_stats();
+    for (frame = 1; frame <= frames; ++frame) {
+        host::advance_us(16000);
+        display.frame();
+        HOST_CHECK(count_mismatches(display) == 0);
+    }
+    const auto stats = display.get_flush_stats();
+    const auto fpga = display.fpga().sim_stats();
+    HOST_CHECK(fpga.out_of_bounds == 0);
+    const double n = frames;
+    std::printf("%3u MHz  %-14s %9.0f %7.1f %9.0f %9.0f\n",
+                static_cast<unsigned>(speed / 1000000), workload_name(workload),
+                (stats.bytes - stats_before.bytes) / n,
+                (stats.commands - stats_before.commands) / n,
+                (fpga.link_us - fpga_before.link_us) / n,
+                (stats.flush_micros - stats_before.flush_micros) / n);
+}
+
+int main(int argc, char **argv) {
+    const uint32_t frames = argc > 1 ? std::atoi(argv[1]) : 120;
+    // Time the host code as it runs; the link is simulated on top.
+    host::set_count_cpu_time(true);
+    std::printf("128x32 chain, %u frames per row; per-frame averages\n",
+                static_cast<unsigned>(frames));
+    std::printf("clock    workload        payload B   cmds   link us  flush us\n");
+    for (auto speed : {FPGA_SPI_CFG::HZ_10M, FPGA_SPI_CFG::HZ_26M,
+                       FPGA_SPI_CFG::HZ_40M}) {
+        for (Workload workload :
+             {Workload::FULL, Workload::SPARSE, Workload::MARQUEE,
+              Workload::IDLE, Workload::ICONS, Workload::SCROLL})
+            run(speed, workload, frames);
+    }
+    return 0;
+}
@@ -0,0 +1,107 @@
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+// A MatrixDisplay opened up for host tests and benchmarks, with helpers to
+// drive frames on the simulated clock and check what reached the panel.
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+
+#include "host.h"
+#include "matrix_display.h"
+
+namespace host {
+
+using esphome::Color;
+using esphome::matrix_display::MatrixDisplay;
+
+class HostDisplay : public MatrixDisplay {
+  public:
+    /// @brief a panel chain with the status SPI wired, not yet set up
+    HostDisplay(int width, int height, int chain_length,
+                FPGA_SPI_CFG::clk_speed speed = FPGA_SPI_CFG::HZ_20M) {
+        static esphome::InternalGPIOPin pins[8] = {
+            esphome::InternalGPIOPin(1), esphome::InternalGPIOPin(2),
+            esphome::InternalGPIOPin(3), esphome::InternalGPIOPin(4),
+            esphome::InternalGPIOPin(5), esphome::InternalGPIOPin(6),
+            esphome::InternalGPIOPin(7), esphome::InternalGPIOPin(8)};
+        this->set_pins(&pins[0], &pins[1], &pins[2], &pins[3], &pins[4]);
+        this->set_status_pins(&pins[5], &pins[6], &pins[7]);
+        this->set_panel_width(width);
+        this->set_panel_height(height);
+        this->set_chain_length(chain_length);
+        this->set_spispeed(speed);
+        this->set_update_interval(16);
+        // Status reads stay synchronous: the harness has no tasks.
+        this->set_status_poll_interval_ms(0);
+    }
+
+    MatrixPanel_FPGA_SPI &fpga() { return *this->dma_display_; }
+    const uint8_t *framebuffer() const { return this->buffer_; }
+    int width() { return this->get_width_internal(); }
+    int height() { return this->get_height_internal(); }
+    int chunk_width() const { return this->chunk_width_; }
+    bool flush_idle() const { return this->flush_state_ == FlushState::IDLE; }
+    FPGA_SPI_CFG::clk_speed spispeed() const {
+        return this->mxconfig_.spispeed;
+    }
+    size_t command_overhead_bytes() const {
+        return this->command_overhead_bytes_;
+    }
+
+    /// @brief a framebuffer pixel expanded to RGB888 as the flush sends it,
+    /// colour correction included
+    void expected_rgb(int x, int y, uint8_t *rgb) const {
+        this->expand_pixel_(rgb, this->buffer_, this->pixel_index_(x, y));
+    }
+
+    /// @brief runs update(), then loop() as the main loop would until a
+    /// budgeted pass is committed, and lets the worker finish, so the frame
+    /// is on the panel
+    void frame() {
+        this->update();
+        while (!this->flush_idle()) {
+            host::advance_us(100);
+            this->loop();
+        }
+        this->drain();
+    }
+
+    /// @brief advances the clock until the worker has sent everything
+    void drain() {
+        while (!this->dma_display_->worker_is_idle())
+            host::advance_us(100);
+    }
+};
+
+/// @brief number of pixels whose front-buffer value on an unremapped chain
+/// differs from the display's framebuffer
+inline int count_mismatches(HostDisplay &display) {
+    const std::vector<uint8_t> &front = display.fpga().sim_front();
+    int mismatches = 0;
+    for (int y = 0; y < display.height(); ++y) {
+        for (int x = 0; x < display.width(); ++x) {
+            uint8_t expected[3];
+            display.expected_rgb(x, y, expected);
+            const uint8_t *px =
+                front.data() + (static_cast<size_t>(y) * display.width() + x) * 3;
+            if (std::memcmp(px, expected, 3) != 0)
+                mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+/// @brief test assertion that reports the failing expression and exits
+#define HOST_CHECK(cond)                                                       \
+    do {                                                                       \
+        if (!(cond)) {                                                         \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__,        \
+                         __LINE__, #cond);                                     \
+            std::exit(1);                                                      \
+        }                                                                      \
+    } while (0)
+
+} // namespace host
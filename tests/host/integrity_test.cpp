@@ -0,0 +1,72 @@
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+// Integrity check: the stand-in damages one byte of every nth rect payload,
+// and every frame the FPGA swaps to the front must still match the
+// framebuffer, because a damaged group is sent again before the swap. Runs
+// with the SPI worker on and off, and with a content diff whose reference
+// already counts the damaged rows as sent.
+//
+// Usage: integrity_test [frames]
+#include <cstdio>
+#include <cstdlib>
+
+#include "host_display.h"
+#include "workloads.h"
+
+using namespace host;
+using esphome::matrix_display::ContentDiffMode;
+
+static void run(Workload workload, bool worker, ContentDiffMode diff,
+                uint32_t frames) {
+    FpgaSimModel &model = MatrixPanel_FPGA_SPI::sim_model();
+    HostDisplay display(64, 32, 2, FPGA_SPI_CFG::HZ_26M);
+    display.set_auto_clear(false);
+    display.set_integrity_register(model.integrity_addr);
+    display.set_content_diff(diff);
+    uint32_t frame = 0;
+    display.set_writer([&](esphome::display::Display &) {
+        run_workload(display, workload, frame);
+    });
+    display.setup();
+    HOST_CHECK(!display.is_failed());
+    if (!worker)
+        display.fpga().enable_worker(false);
+    // Checked as each swap lands, before the next frame is drawn.
+    uint32_t swaps = 0, bad_swaps = 0;
+    model.on_swap = [&](const MatrixPanel_FPGA_SPI &) {
+        swaps++;
+        if (count_mismatches(display) != 0)
+            bad_swaps++;
+    };
+    model.corrupt_every = 7;
+    for (frame = 0; frame < frames; ++frame) {
+        host::advance_us(16000);
+        display.frame();
+    }
+    model.corrupt_every = 0;
+    model.on_swap = nullptr;
+    const auto stats = display.get_flush_stats();
+    const auto fpga = display.fpga().sim_stats();
+    std::printf("%-13s worker %-3s diff %-4s: %u swaps, %u damaged rects, "
+                "%u chunks re-sent, %u bad swaps\n",
+                workload_name(workload), worker ? "on" : "off",
+                diff == ContentDiffMode::HASH ? "hash" : "none", swaps,
+                static_cast<unsigned>(fpga.corrupted),
+                static_cast<unsigned>(stats.corrupt_chunks), bad_swaps);
+    HOST_CHECK(fpga.corrupted > 0);
+    HOST_CHECK(stats.corrupt_chunks > 0);
+    HOST_CHECK(swaps > 0);
+    HOST_CHECK(bad_swaps == 0);
+}
+
+int main(int argc, char **argv) {
+    const uint32_t frames = argc > 1 ? std::atoi(argv[1]) : 60;
+    for (Workload workload : {Workload::FULL, Workload::SPARSE, Workload::ICONS}) {
+        for (bool worker : {true, false}) {
+            run(workload, worker, ContentDiffMode::NONE, frames);
+            run(workload, worker, ContentDiffMode::HASH, frames);
+        }
+    }
+    std::printf("integrity OK\n");
+    return 0;
+}
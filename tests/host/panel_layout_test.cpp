@@ -0,0 +1,208 @@
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+// PanelLayout against a naive per-pixel mapping, for every combination of
+// panel rotations and serpentine wiring on small grids: split() must cut
+// rects into pieces that tile them, one panel each, whose chain rects hold
+// exactly the chain pixels the reference maps their logical pixels to. A
+// full display then checks the packed pixel order on the simulated FPGA.
+#include <cstdio>
+#include <vector>
+
+#include "host_display.h"
+#include "panel_layout.h"
+
+using namespace host;
+using esphome::matrix_display::PanelLayout;
+
+namespace {
+
+struct Grid {
+    int panel_width, panel_height, rows, chain_length;
+};
+
+/// @brief where logical pixel (x, y) lands on the chain, worked out one
+/// pixel at a time: find the panel, then undo its clockwise mounting
+void reference(const Grid &grid, bool serpentine,
+               const std::vector<uint8_t> &turns, int x, int y, int &cx,
+               int &cy) {
+    const int pw = grid.panel_width;
+    const int ph = grid.panel_height;
+    const int columns = grid.chain_length / grid.rows;
+    const int row = y / ph;
+    const int column = x / pw;
+    const bool reversed = serpentine && row % 2 == 1;
+    const int panel = row * columns + (reversed ? columns - 1 - column : column);
+    int k = turns[static_cast<size_t>(panel)];
+    if (k % 2 == 1 && pw != ph)
+        k = 0;
+    const int u = x % pw;
+    const int v = y % ph;
+    int pu = u, pv = v;
+    switch (k) {
+    case 1:
+        pu = v;
+        pv = pw - 1 - u;
+        break;
+    case 2:
+        pu = pw - 1 - u;
+        pv = ph - 1 - v;
+        break;
+    case 3:
+        pu = ph - 1 - v;
+        pv = u;
+        break;
+    }
+    cx = panel * pw + pu;
+    cy = pv;
+}
+
+/// @brief checks one split() result against the reference
+void check_rect(const PanelLayout &layout, const Grid &grid, bool serpentine,
+                const std::vector<uint8_t> &turns, int x, int y, int w, int h,
+                std::vector<PanelLayout::Piece> &pieces,
+                std::vector<uint8_t> &covered) {
+    layout.split(x, y, w, h, pieces);
+    const int width = layout.width();
+    covered.assign(static_cast<size_t>(width) * layout.height(), 0);
+    long area = 0;
+    for (const PanelLayout::Piece &piece : pieces) {
+        HOST_CHECK(piece.w > 0 && piece.h > 0);
+        HOST_CHECK(piece.x >= x && piece.y >= y && piece.x + piece.w <= x + w &&
+                   piece.y + piece.h <= y + h);
+        // One panel per piece, unless the chain is the canvas.
+        HOST_CHECK(layout.is_identity() ||
+                   (piece.x / grid.panel_width ==
+                        (piece.x + piece.w - 1) / grid.panel_width &&
+                    piece.y / grid.panel_height ==
+                        (piece.y + piece.h - 1) / grid.panel_height));
+        HOST_CHECK(piece.chain_w * piece.chain_h == piece.w * piece.h);
+        area += static_cast<long>(piece.w) * piece.h;
+        for (int py = piece.y; py < piece.y + piece.h; ++py) {
+            for (int px = piece.x; px < piece.x + piece.w; ++px) {
+                uint8_t &seen = covered[static_cast<size_t>(py) * width + px];
+                HOST_CHECK(seen == 0);
+                seen = 1;
+                int cx, cy;
+                reference(grid, serpentine, turns, px, py, cx, cy);
+                // The reference is one-to-one, so landing inside a chain
+                // rect of the same area means covering it exactly.
+                HOST_CHECK(cx >= piece.chain_x &&
+                           cx < piece.chain_x + piece.chain_w &&
+                           cy >= piece.chain_y &&
+                           cy < piece.chain_y + piece.chain_h);
+            }
+        }
+    }
+    HOST_CHECK(area == static_cast<long>(w) * h);
+}
+
+/// @return rotation combinations checked
+int check_grid(const Grid &grid) {
+    PanelLayout layout;
+    std::vector<PanelLayout::Piece> pieces;
+    std::vector<uint8_t> covered;
+    std::vector<uint8_t> turns(static_cast<size_t>(grid.chain_length));
+    int combinations = 0;
+    int total = 1;
+    for (int i = 0; i < grid.chain_length; ++i)
+        total *= 4;
+    for (bool serpentine : {false, true}) {
+        for (int combo = 0; combo < total; ++combo) {
+            for (int i = 0, rest = combo; i < grid.chain_length; ++i, rest /= 4)
+                turns[static_cast<size_t>(i)] = static_cast<uint8_t>(rest % 4);
+            layout.configure(grid.panel_width, grid.panel_height, grid.rows,
+                             grid.chain_length, serpentine, turns);
+            // Every pixel on its own.
+            for (int y = 0; y < layout.height(); ++y) {
+                for (int x = 0; x < layout.width(); ++x) {
+                    layout.split(x, y, 1, 1, pieces);
+                    HOST_CHECK(pieces.size() == 1);
+                    int cx, cy;
+                    reference(grid, serpentine, turns, x, y, cx, cy);
+                    HOST_CHECK(pieces[0].chain_x == cx &&
+                               pieces[0].chain_y == cy &&
+                               pieces[0].chain_w == 1 &&
+                               pieces[0].chain_h == 1);
+                }
+            }
+            // The whole canvas, and rects straddling panel edges.
+            check_rect(layout, grid, serpentine, turns, 0, 0, layout.width(),
+                       layout.height(), pieces, covered);
+            uint32_t seed = static_cast<uint32_t>(combo) * 2 + serpentine + 1;
+            for (int i = 0; i < 16; ++i) {
+                seed = seed * 1103515245u + 12345u;
+                const int x = (seed >> 8) % layout.width();
+                const int y = (seed >> 16) % layout.height();
+                seed = seed * 1103515245u + 12345u;
+                const int w = 1 + (seed >> 8) % (layout.width() - x);
+                const int h = 1 + (seed >> 16) % (layout.height() - y);
+                check_rect(layout, grid, serpentine, turns, x, y, w, h, pieces,
+                           covered);
+            }
+            combinations++;
+        }
+    }
+    return combinations;
+}
+
+/// @brief draws through a full display and checks the FPGA's front buffer
+/// pixel by pixel against the reference
+void check_display(const Grid &grid, bool serpentine,
+                   const std::vector<uint8_t> &turns) {
+    HostDisplay display(grid.panel_width, grid.panel_height, grid.chain_length);
+    display.set_layout(grid.rows, serpentine, turns);
+    uint32_t seed = 3;
+    display.set_writer([&](esphome::display::Display &it) {
+        it.fill(Color(0, 0, 40));
+        it.filled_rectangle(3, 5, it.get_width() - 6, 7, Color(0, 120, 0));
+        for (int i = 0; i < 200; ++i) {
+            seed = seed * 1103515245u + 12345u;
+            it.draw_pixel_at((seed >> 8) % it.get_width(),
+                             (seed >> 16) % it.get_height(),
+                             Color(seed & 0xFF, (seed >> 4) & 0xFF, 255));
+        }
+    });
+    display.setup();
+    HOST_CHECK(!display.is_failed());
+    for (int frame = 0; frame < 3; ++frame) {
+        host::advance_us(16000);
+        display.frame();
+        const std::vector<uint8_t> &front = display.fpga().sim_front();
+        const int chain_width = display.fpga().sim_width();
+        for (int y = 0; y < display.height(); ++y) {
+            for (int x = 0; x < display.width(); ++x) {
+                int cx, cy;
+                reference(grid, serpentine, turns, x, y, cx, cy);
+                uint8_t expected[3];
+                display.expected_rgb(x, y, expected);
+                const uint8_t *px =
+                    front.data() +
+                    (static_cast<size_t>(cy) * chain_width + cx) * 3;
+                HOST_CHECK(std::memcmp(px, expected, 3) == 0);
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    // Square panels take every rotation; on non-square ones quarter turns
+    // fall back to unrotated.
+    const Grid grids[] = {{8, 8, 2, 4}, {8, 8, 1, 3}, {8, 8, 3, 3},
+                          {16, 8, 2, 4}};
+    for (const Grid &grid : grids) {
+        const int combinations = check_grid(grid);
+        std::printf("%dx%d panels, %d rows of %d: %d layouts OK\n",
+                    grid.panel_width, grid.panel_height, grid.rows,
+                    grid.chain_length / grid.rows, combinations);
+    }
+    const Grid grid{16, 16, 2, 4};
+    for (bool serpentine : {false, true}) {
+        check_display(grid, serpentine, {0, 1, 2, 3});
+        check_display(grid, serpentine, {3, 2, 1, 0});
+        check_display(grid, serpentine, {2, 2, 1, 3});
+    }
+    std::printf("panel layout display round trip OK\n");
+    return 0;
+}
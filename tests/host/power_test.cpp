@@ -0,0 +1,83 @@
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+// With suspend_watchdog_when_off, a display switched off stops feeding the
+// FPGA watchdog and stays that way across a panel restart. An FPGA reset
+// while dark is resynced at once, the panel stays blank, and switching back
+// on restores the framebuffer and the feed. The status poller stays off the
+// status SPI while the display is off.
+#include <algorithm>
+#include <cstdio>
+
+#include "host_display.h"
+
+using namespace host;
+using esphome::matrix_display::PowerState;
+
+class PowerDisplay : public HostDisplay {
+  public:
+    using HostDisplay::HostDisplay;
+    bool watchdog_running() const {
+        return host::timer_running(this->periodic_timer);
+    }
+    bool restart() { return this->restart_panel_(this->mxconfig_.spispeed); }
+    /// @brief one burst of the status poller, which the harness cannot run
+    /// as a task
+    void poll_status() { this->poll_status_(); }
+};
+
+int main() {
+    PowerDisplay display(64, 32, 2);
+    display.set_initial_watchdog(true);
+    display.set_suspend_watchdog_when_off(true);
+    display.set_writer([](esphome::display::Display &it) {
+        it.fill(Color(0, 0, 0));
+        it.filled_rectangle(10, 4, 20, 12, Color(200, 40, 90));
+    });
+    display.setup();
+    HOST_CHECK(!display.is_failed());
+    display.frame();
+    HOST_CHECK(count_mismatches(display) == 0);
+    HOST_CHECK(display.watchdog_running());
+    display.request_status(MatrixPanel_FPGA_SPI::STATUS_ADDR_FB_FPS);
+    uint32_t reads = display.fpga().sim_status_reads();
+    display.poll_status();
+    HOST_CHECK(display.fpga().sim_status_reads() > reads);
+
+    display.set_state(false);
+    while (display.get_power_state() != PowerState::OFF) {
+        host::advance_us(100);
+        display.loop();
+    }
+    display.drain();
+    HOST_CHECK(!display.watchdog_running());
+
+    // A restart while off (calibration, a clock step-down) leaves the
+    // watchdog suspended.
+    HOST_CHECK(display.restart());
+    HOST_CHECK(!display.watchdog_running());
+
+    // The FPGA resets while dark: update() picks it up without drawing.
+    display.fpga().sim_reset();
+    display.update();
+    display.drain();
+    HOST_CHECK(!display.fpga().consume_fpga_reset());
+    const std::vector<uint8_t> &front = display.fpga().sim_front();
+    HOST_CHECK(std::all_of(front.begin(), front.end(),
+                           [](uint8_t byte) { return byte == 0; }));
+    const uint32_t feeds = display.fpga().sim_watchdog_feeds();
+    host::advance_us(5000000);
+    HOST_CHECK(display.fpga().sim_watchdog_feeds() == feeds);
+    reads = display.fpga().sim_status_reads();
+    display.poll_status();
+    HOST_CHECK(display.fpga().sim_status_reads() == reads);
+
+    display.set_state(true);
+    HOST_CHECK(display.watchdog_running());
+    display.poll_status();
+    HOST_CHECK(display.fpga().sim_status_reads() > reads);
+    display.frame();
+    HOST_CHECK(count_mismatches(display) == 0);
+    std::printf("power: watchdog suspended across restart, reset resynced "
+                "while off\n");
+    return 0;
+}
@@ -0,0 +1,156 @@
+// SPDX-FileCopyrightText: 2019 ESPHome
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+// Host stand-in for ESPHome's Display and DisplayBuffer. The base drawing
+// paths mirror ESPHome's per-pixel implementations, so the component's bulk
+// overrides can be measured against them.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "esphome/core/component.h"
+
+namespace esphome {
+
+struct Color {
+    union {
+        struct {
+            uint8_t r, g, b, w;
+        };
+        struct {
+            uint8_t red, green, blue, white;
+        };
+        uint32_t raw_32;
+    };
+    Color() : raw_32(0) {}
+    Color(uint8_t red, uint8_t green, uint8_t blue, uint8_t white = 0)
+        : r(red), g(green), b(blue), w(white) {}
+    bool operator==(const Color &other) const {
+        return this->raw_32 == other.raw_32;
+    }
+    bool operator!=(const Color &other) const { return !(*this == other); }
+
+    static const Color BLACK;
+    static const Color WHITE;
+};
+
+namespace display {
+
+enum DisplayType {
+    DISPLAY_TYPE_BINARY = 1,
+    DISPLAY_TYPE_GRAYSCALE = 2,
+    DISPLAY_TYPE_COLOR = 3,
+};
+
+enum DisplayRotation {
+    DISPLAY_ROTATION_0_DEGREES = 0,
+    DISPLAY_ROTATION_90_DEGREES = 90,
+    DISPLAY_ROTATION_180_DEGREES = 180,
+    DISPLAY_ROTATION_270_DEGREES = 270,
+};
+
+enum ColorOrder : uint8_t {
+    COLOR_ORDER_RGB = 0,
+    COLOR_ORDER_BGR = 1,
+    COLOR_ORDER_GRB = 2,
+};
+
+enum ColorBitness : uint8_t {
+    COLOR_BITNESS_888 = 0,
+    COLOR_BITNESS_565 = 1,
+    COLOR_BITNESS_332 = 2,
+};
+
+static constexpr int16_t VALUE_NO_SET = 32766;
+
+struct Rect {
+    int16_t x = VALUE_NO_SET;
+    int16_t y = VALUE_NO_SET;
+    int16_t w = VALUE_NO_SET;
+    int16_t h = VALUE_NO_SET;
+
+    Rect() = default;
+    Rect(int16_t x, int16_t y, int16_t w, int16_t h) : x(x), y(y), w(w), h(h) {}
+    bool is_set() const { return this->h != VALUE_NO_SET && this->w != VALUE_NO_SET; }
+    int16_t x2() const { return this->x + this->w; }
+    int16_t y2() const { return this->y + this->h; }
+    bool inside(int16_t test_x, int16_t test_y) const {
+        if (!this->is_set())
+            return true;
+        return test_x >= this->x && test_x < this->x2() &&
+               test_y >= this->y && test_y < this->y2();
+    }
+};
+
+extern const Color COLOR_OFF;
+extern const Color COLOR_ON;
+
+class Display;
+using display_writer_t = std::function<void(Display &)>;
+
+class Display : public PollingComponent {
+  public:
+    virtual void fill(Color color);
+    void clear() { this->fill(COLOR_OFF); }
+
+    virtual void draw_pixel_at(int x, int y, Color color) = 0;
+    virtual void draw_pixels_at(int x_start, int y_start, int w, int h,
+                                const uint8_t *ptr, ColorOrder order,
+                                ColorBitness bitness, bool big_endian,
+                                int x_offset, int y_offset, int x_pad);
+    void filled_rectangle(int x1, int y1, int width, int height,
+                          Color color = COLOR_ON);
+    void horizontal_line(int x, int y, int width, Color color = COLOR_ON);
+
+    virtual int get_width() { return this->get_width_internal(); }
+    virtual int get_height() { return this->get_height_internal(); }
+    virtual DisplayType get_display_type() = 0;
+    DisplayRotation get_rotation() const { return this->rotation_; }
+    void set_auto_clear(bool auto_clear) {
+        this->auto_clear_enabled_ = auto_clear;
+    }
+
+    void start_clipping(Rect rect) { this->clipping_rectangle_.push_back(rect); }
+    void start_clipping(int16_t left, int16_t top, int16_t right,
+                        int16_t bottom) {
+        this->start_clipping(Rect(left, top, right - left, bottom - top));
+    }
+    void end_clipping() {
+        if (!this->clipping_rectangle_.empty())
+            this->clipping_rectangle_.pop_back();
+    }
+    Rect get_clipping() const {
+        return this->clipping_rectangle_.empty()
+                   ? Rect()
+                   : this->clipping_rectangle_.back();
+    }
+    bool is_clipping() const { return !this->clipping_rectangle_.empty(); }
+
+    void set_writer(display_writer_t &&writer) { this->writer_ = writer; }
+
+  protected:
+    virtual int get_width_internal() = 0;
+    virtual int get_height_internal() = 0;
+    void do_update_();
+
+    DisplayRotation rotation_{DISPLAY_ROTATION_0_DEGREES};
+    bool auto_clear_enabled_{true};
+    display_writer_t writer_;
+    std::vector<Rect> clipping_rectangle_;
+};
+
+class DisplayBuffer : public Display {
+  public:
+    void draw_pixel_at(int x, int y, Color color) override;
+
+  protected:
+    virtual void draw_absolute_pixel_internal(int x, int y, Color color) = 0;
+
+    uint8_t *buffer_{nullptr};
+};
+
+} // namespace display
+} // namespace esphome
@@ -0,0 +1,65 @@
+// SPDX-FileCopyrightText: 2019 ESPHome
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+// Host stand-in for ESPHome's ColorUtil, with the same conversions.
+#pragma once
+
+#include "esphome/components/display/display_buffer.h"
+
+namespace esphome {
+namespace display {
+
+class ColorUtil {
+  public:
+    static Color to_color(uint32_t colorcode, ColorOrder color_order,
+                          ColorBitness color_bitness = COLOR_BITNESS_888,
+                          bool right_bit_aligned = true) {
+        int first_bits = 8;
+        int second_bits = 8;
+        int third_bits = 8;
+        switch (color_bitness) {
+        case COLOR_BITNESS_888:
+            break;
+        case COLOR_BITNESS_565:
+            first_bits = 5;
+            second_bits = 6;
+            third_bits = 5;
+            break;
+        case COLOR_BITNESS_332:
+            first_bits = 3;
+            second_bits = 3;
+            third_bits = 2;
+            break;
+        }
+        const uint8_t first = scale_(
+            right_bit_aligned
+                ? (colorcode >> (second_bits + third_bits)) & ((1 << first_bits) - 1)
+                : (colorcode >> 16) & 0xFF,
+            right_bit_aligned ? (1 << first_bits) - 1 : 0xFF);
+        const uint8_t second = scale_(
+            right_bit_aligned ? (colorcode >> third_bits) & ((1 << second_bits) - 1)
+                              : (colorcode >> 8) & 0xFF,
+            right_bit_aligned ? (1 << second_bits) - 1 : 0xFF);
+        const uint8_t third = scale_(
+            right_bit_aligned ? colorcode & ((1 << third_bits) - 1)
+                              : colorcode & 0xFF,
+            right_bit_aligned ? (1 << third_bits) - 1 : 0xFF);
+        switch (color_order) {
+        case COLOR_ORDER_BGR:
+            return Color(third, second, first);
+        case COLOR_ORDER_GRB:
+            return Color(second, first, third);
+        case COLOR_ORDER_RGB:
+        default:
+            return Color(first, second, third);
+        }
+    }
+
+  protected:
+    static uint8_t scale_(uint32_t value, uint32_t max) {
+        return static_cast<uint8_t>(value * 255 / max);
+    }
+};
+
+} // namespace display
+} // namespace esphome
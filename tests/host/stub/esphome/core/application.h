@@ -0,0 +1,17 @@
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+// Host stand-in for ESPHome's Application; there is no task watchdog.
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+
+class Application {
+  public:
+    void feed_wdt(uint32_t time = 0) {}
+};
+
+extern Application App;
+
+} // namespace esphome
@@ -0,0 +1,44 @@
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+// Host stand-in for ESPHome's component base classes. The test drives
+// setup(), loop() and update() itself.
+#pragma once
+
+#include <cstdint>
+
+#include "esphome/core/hal.h"
+
+namespace esphome {
+
+namespace setup_priority {
+const float HARDWARE = 800.0f;
+const float PROCESSOR = 400.0f;
+} // namespace setup_priority
+
+class Component {
+  public:
+    virtual ~Component() = default;
+    virtual void setup() {}
+    virtual void loop() {}
+    virtual void dump_config() {}
+    virtual float get_setup_priority() const { return 0.0f; }
+    void mark_failed() { this->failed_ = true; }
+    bool is_failed() const { return this->failed_; }
+
+  protected:
+    bool failed_ = false;
+};
+
+class PollingComponent : public Component {
+  public:
+    virtual void update() = 0;
+    virtual void set_update_interval(uint32_t update_interval) {
+        this->update_interval_ = update_interval;
+    }
+    uint32_t get_update_interval() const { return this->update_interval_; }
+
+  protected:
+    uint32_t update_interval_ = 1000;
+};
+
+} // namespace esphome
@@ -0,0 +1,25 @@
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+// Host stand-in for the parts of ESPHome's HAL the component uses.
+#pragma once
+
+#include <cstdint>
+
+#define HOT
+
+namespace esphome {
+
+/// Simulated clock, see host.h.
+uint32_t micros();
+uint32_t millis();
+
+class InternalGPIOPin {
+  public:
+    explicit InternalGPIOPin(uint8_t pin = 0) : pin_(pin) {}
+    uint8_t get_pin() const { return this->pin_; }
+
+  protected:
+    uint8_t pin_;
+};
+
+} // namespace esphome
@@ -0,0 +1,27 @@
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+// Host stand-in for the ESPHome helpers the component uses.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace esphome {
+
+template <typename T> T clamp(T value, T min, T max) {
+    return value < min ? min : (value > max ? max : value);
+}
+
+std::string format_hex_pretty(const uint8_t *data, size_t length);
+
+uint32_t fnv1_hash(const std::string &str);
+
+/// Nothing to speed up on the host; the loop is driven by the test.
+class HighFrequencyLoopRequester {
+  public:
+    void start() {}
+    void stop() {}
+};
+
+} // namespace esphome
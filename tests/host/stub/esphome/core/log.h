@@ -0,0 +1,20 @@
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+// Host stand-in for ESPHome logging. Messages at or above the level in the
+// HOST_LOG environment variable (E, W, I, D, V; default W) go to stderr.
+#pragma once
+
+namespace esphome {
+
+void host_log(char level, const char *tag, const char *format, ...)
+    __attribute__((format(printf, 3, 4)));
+
+} // namespace esphome
+
+#define ESP_LOGE(tag, ...) ::esphome::host_log('E', tag, __VA_ARGS__)
+#define ESP_LOGW(tag, ...) ::esphome::host_log('W', tag, __VA_ARGS__)
+#define ESP_LOGI(tag, ...) ::esphome::host_log('I', tag, __VA_ARGS__)
+#define ESP_LOGD(tag, ...) ::esphome::host_log('D', tag, __VA_ARGS__)
+#define ESP_LOGV(tag, ...) ::esphome::host_log('V', tag, __VA_ARGS__)
+#define ESP_LOGCONFIG(tag, ...) ::esphome::host_log('C', tag, __VA_ARGS__)
+#define YESNO(b) ((b) ? "YES" : "NO")
@@ -0,0 +1,44 @@
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+// Host stand-in for ESPHome preferences: an in-memory store that lives for
+// the process, so a test can "reboot" a display and find what it saved.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+
+class ESPPreferenceObject {
+  public:
+    ESPPreferenceObject() = default;
+    explicit ESPPreferenceObject(uint32_t key) : key_(key), valid_(true) {}
+
+    template <typename T> bool save(const T *src) {
+        return this->save_(reinterpret_cast<const uint8_t *>(src), sizeof(T));
+    }
+    template <typename T> bool load(T *dest) {
+        return this->load_(reinterpret_cast<uint8_t *>(dest), sizeof(T));
+    }
+
+  protected:
+    bool save_(const uint8_t *data, size_t len);
+    bool load_(uint8_t *data, size_t len);
+
+    uint32_t key_ = 0;
+    bool valid_ = false;
+};
+
+class ESPPreferences {
+  public:
+    template <typename T>
+    ESPPreferenceObject make_preference(uint32_t type, bool in_flash = false) {
+        return ESPPreferenceObject(type);
+    }
+    /// @brief forgets everything saved so far
+    void reset();
+};
+
+extern ESPPreferences *global_preferences;
+
+} // namespace esphome
@@ -0,0 +1,14 @@
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+// Host stand-in for FreeRTOS mutexes. With a single thread a mutex that is
+// already held can never be given back, so a blocking take aborts instead
+// of hanging; a take with a timeout fails.
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct HostMutex *SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex();
+BaseType_t xSemaphoreTake(SemaphoreHandle_t mutex, TickType_t ticks);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t mutex);
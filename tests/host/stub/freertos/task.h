@@ -0,0 +1,23 @@
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+// Host stand-in for FreeRTOS tasks. The harness is single-threaded: delays
+// advance the simulated clock and task creation fails, so the component
+// takes its inline fallbacks.
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+typedef void *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+void vTaskDelay(TickType_t ticks);
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char *name,
+                                   uint32_t stack_depth, void *arg,
+                                   UBaseType_t priority, TaskHandle_t *handle,
+                                   BaseType_t core);
+TaskHandle_t xTaskGetCurrentTaskHandle();
+inline void vTaskDelete(TaskHandle_t task) {}
+inline void xTaskNotifyGive(TaskHandle_t task) {}
+inline uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks) {
+    return 0;
+}
@@ -0,0 +1,303 @@
+// SPDX-FileCopyrightText: 2019 ESPHome
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+// Definitions behind the host stand-ins: the simulated clock and timers,
+// FreeRTOS, the allocator, preferences, logging and the ESPHome display
+// base classes.
+#include "host.h"
+
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "esphome/components/display/display_buffer.h"
+#include "esphome/components/display/display_color_utils.h"
+#include "esphome/core/application.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+#include "esphome/core/preferences.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+struct esp_timer {
+    esp_timer_cb_t callback;
+    void *arg;
+    uint64_t period_us;
+    uint64_t next_us;
+    bool running;
+};
+
+struct HostMutex {
+    bool held;
+};
+
+namespace host {
+
+static uint64_t simulated_us = 0;
+static bool count_cpu_time = false;
+static std::chrono::steady_clock::time_point cpu_epoch =
+    std::chrono::steady_clock::now();
+static int allocations_left = -1;
+static std::vector<esp_timer *> timers;
+static bool firing_timers = false;
+static void *current_task = nullptr;
+
+uint64_t now_us() {
+    if (!count_cpu_time)
+        return simulated_us;
+    const auto elapsed = std::chrono::steady_clock::now() - cpu_epoch;
+    return simulated_us +
+           std::chrono::duration_cast<std::chrono::microseconds>(elapsed)
+               .count();
+}
+
+void advance_us(uint64_t us) {
+    simulated_us += us;
+    // A callback that advances the clock itself must not re-enter.
+    if (firing_timers)
+        return;
+    firing_timers = true;
+    const uint64_t now = now_us();
+    for (esp_timer *timer : timers) {
+        while (timer->running && timer->period_us != 0 &&
+               timer->next_us <= now) {
+            timer->next_us += timer->period_us;
+            timer->callback(timer->arg);
+        }
+    }
+    firing_timers = false;
+}
+
+void set_count_cpu_time(bool enable) {
+    // Keep the clock continuous across the switch.
+    const uint64_t now = now_us();
+    count_cpu_time = enable;
+    cpu_epoch = std::chrono::steady_clock::now();
+    simulated_us = now;
+}
+
+void fail_allocations_after(int count) { allocations_left = count; }
+
+void set_current_task(void *task) { current_task = task; }
+
+bool timer_running(const esp_timer *timer) {
+    return timer != nullptr && timer->running;
+}
+
+} // namespace host
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args,
+                           esp_timer_handle_t *out_handle) {
+    auto *timer = new esp_timer{args->callback, args->arg, 0, 0, false};
+    host::timers.push_back(timer);
+    *out_handle = timer;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period) {
+    timer->period_us = period;
+    timer->next_us = host::now_us() + period;
+    timer->running = true;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+    timer->running = false;
+    return ESP_OK;
+}
+
+int64_t esp_timer_get_time() { return static_cast<int64_t>(host::now_us()); }
+
+void vTaskDelay(TickType_t ticks) {
+    host::advance_us(static_cast<uint64_t>(ticks) * 1000);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() { return host::current_task; }
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char *name,
+                                   uint32_t stack_depth, void *arg,
+                                   UBaseType_t priority, TaskHandle_t *handle,
+                                   BaseType_t core) {
+    return pdFAIL;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex() { return new HostMutex{false}; }
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t mutex, TickType_t ticks) {
+    if (mutex->held) {
+        if (ticks == portMAX_DELAY) {
+            std::fprintf(stderr, "deadlock: mutex taken twice\n");
+            std::abort();
+        }
+        return pdFALSE;
+    }
+    mutex->held = true;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t mutex) {
+    mutex->held = false;
+    return pdTRUE;
+}
+
+void *heap_caps_malloc(size_t size, uint32_t caps) {
+    if (host::allocations_left == 0)
+        return nullptr;
+    if (host::allocations_left > 0)
+        host::allocations_left--;
+    return std::malloc(size);
+}
+
+void heap_caps_free(void *ptr) { std::free(ptr); }
+
+namespace esphome {
+
+Application App;
+
+static ESPPreferences preferences;
+ESPPreferences *global_preferences = &preferences;
+static std::map<uint32_t, std::vector<uint8_t>> preference_store;
+
+bool ESPPreferenceObject::save_(const uint8_t *data, size_t len) {
+    if (!this->valid_)
+        return false;
+    preference_store[this->key_].assign(data, data + len);
+    return true;
+}
+
+bool ESPPreferenceObject::load_(uint8_t *data, size_t len) {
+    auto it = preference_store.find(this->key_);
+    if (!this->valid_ || it == preference_store.end() ||
+        it->second.size() != len)
+        return false;
+    std::memcpy(data, it->second.data(), len);
+    return true;
+}
+
+void ESPPreferences::reset() { preference_store.clear(); }
+
+uint32_t micros() { return static_cast<uint32_t>(host::now_us()); }
+
+uint32_t millis() { return static_cast<uint32_t>(host::now_us() / 1000); }
+
+void host_log(char level, const char *tag, const char *format, ...) {
+    static const char *const kLevels = "EWICDV";
+    static int threshold = -1;
+    if (threshold < 0) {
+        const char *env = std::getenv("HOST_LOG");
+        const char *found =
+            env != nullptr && *env != '\0' ? std::strchr(kLevels, *env) : nullptr;
+        threshold = found != nullptr ? static_cast<int>(found - kLevels) : 1;
+    }
+    const char *found = std::strchr(kLevels, level);
+    if (found == nullptr || found - kLevels > threshold)
+        return;
+    std::fprintf(stderr, "[%c][%s] ", level, tag);
+    va_list args;
+    va_start(args, format);
+    std::vfprintf(stderr, format, args);
+    va_end(args);
+    std::fputc('\n', stderr);
+}
+
+std::string format_hex_pretty(const uint8_t *data, size_t length) {
+    std::string out;
+    char byte[4];
+    for (size_t i = 0; i < length; ++i) {
+        std::snprintf(byte, sizeof(byte), i == 0 ? "%02X" : ".%02X", data[i]);
+        out += byte;
+    }
+    return out;
+}
+
+uint32_t fnv1_hash(const std::string &str) {
+    uint32_t hash = 2166136261UL;
+    for (char c : str) {
+        hash *= 16777619UL;
+        hash ^= static_cast<uint8_t>(c);
+    }
+    return hash;
+}
+
+const Color Color::BLACK(0, 0, 0, 0);
+const Color Color::WHITE(255, 255, 255, 255);
+
+namespace display {
+
+const Color COLOR_OFF(0, 0, 0, 0);
+const Color COLOR_ON(255, 255, 255, 255);
+
+void Display::fill(Color color) {
+    this->filled_rectangle(0, 0, this->get_width(), this->get_height(), color);
+}
+
+void Display::horizontal_line(int x, int y, int width, Color color) {
+    for (int i = x; i < x + width; ++i)
+        this->draw_pixel_at(i, y, color);
+}
+
+void Display::filled_rectangle(int x1, int y1, int width, int height,
+                               Color color) {
+    for (int y = y1; y < y1 + height; ++y)
+        this->horizontal_line(x1, y, width, color);
+}
+
+void Display::draw_pixels_at(int x_start, int y_start, int w, int h,
+                             const uint8_t *ptr, ColorOrder order,
+                             ColorBitness bitness, bool big_endian,
+                             int x_offset, int y_offset, int x_pad) {
+    const size_t line_stride = x_offset + w + x_pad;
+    uint32_t color_value;
+    for (int y = 0; y != h; ++y) {
+        size_t source_idx = (y_offset + y) * line_stride + x_offset;
+        for (int x = 0; x != w; ++x, ++source_idx) {
+            switch (bitness) {
+            default:
+                color_value = ptr[source_idx];
+                break;
+            case COLOR_BITNESS_565: {
+                const size_t i = source_idx * 2;
+                color_value = big_endian ? (ptr[i] << 8) + ptr[i + 1]
+                                         : ptr[i] + (ptr[i + 1] << 8);
+                break;
+            }
+            case COLOR_BITNESS_888: {
+                const size_t i = source_idx * 3;
+                color_value =
+                    big_endian
+                        ? (ptr[i] << 16) + (ptr[i + 1] << 8) + ptr[i + 2]
+                        : ptr[i] + (ptr[i + 1] << 8) + (ptr[i + 2] << 16);
+                break;
+            }
+            }
+            this->draw_pixel_at(x + x_start, y + y_start,
+                                ColorUtil::to_color(color_value, order,
+                                                    bitness));
+        }
+    }
+}
+
+void Display::do_update_() {
+    if (this->auto_clear_enabled_)
+        this->clear();
+    if (this->writer_)
+        this->writer_(*this);
+    this->clipping_rectangle_.clear();
+}
+
+void DisplayBuffer::draw_pixel_at(int x, int y, Color color) {
+    if (!this->get_clipping().inside(x, y))
+        return;
+    this->draw_absolute_pixel_internal(x, y, color);
+    App.feed_wdt();
+}
+
+} // namespace display
+} // namespace esphome
@@ -0,0 +1,36 @@
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+// Controls of the host harness that have no ESP-IDF counterpart.
+#pragma once
+
+#include <cstdint>
+
+struct esp_timer;
+
+namespace host {
+
+/// @brief simulated time since start, in microseconds
+uint64_t now_us();
+
+/// @brief moves the simulated clock forward, firing due esp_timers
+void advance_us(uint64_t us);
+
+/**
+ * Also counts real CPU time into the clock, so code under test is timed as
+ * it runs on the host. Off (the default) keeps runs deterministic: only
+ * delays and modelled transfers move the clock.
+ */
+void set_count_cpu_time(bool enable);
+
+/// @brief lets `count` more heap_caps_malloc() calls succeed, then fails
+/// every one after; -1 (the default) never fails
+void fail_allocations_after(int count);
+
+/// @brief handle xTaskGetCurrentTaskHandle() returns; nullptr (the
+/// default) stands for the main loop task
+void set_current_task(void *task);
+
+/// @brief whether a periodic esp_timer is currently running
+bool timer_running(const esp_timer *timer);
+
+} // namespace host
@@ -0,0 +1,310 @@
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+#include "matrix_panel_fpga.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "host.h"
+
+/// Window the FPGA averages its RX_KBPS and FB_FPS readings over.
+static constexpr uint64_t kRateWindowUs = 1000000;
+
+FpgaSimModel &MatrixPanel_FPGA_SPI::sim_model() {
+    static FpgaSimModel model;
+    return model;
+}
+
+MatrixPanel_FPGA_SPI::MatrixPanel_FPGA_SPI(const FPGA_SPI_CFG &cfg)
+    : cfg_(cfg) {}
+
+MatrixPanel_FPGA_SPI::~MatrixPanel_FPGA_SPI() {
+    this->service_();
+    if (this->worker_enabled_ || !this->jobs_.empty()) {
+        std::fprintf(stderr, "driver deleted with a live worker (%u jobs)\n",
+                     static_cast<unsigned>(this->jobs_.size()));
+        std::abort();
+    }
+}
+
+bool MatrixPanel_FPGA_SPI::begin() {
+    const size_t bytes = static_cast<size_t>(this->sim_width()) *
+                         this->sim_height() * 3;
+    this->back_.assign(bytes, 0);
+    this->front_.assign(bytes, 0);
+    this->begun_ = true;
+    return true;
+}
+
+bool MatrixPanel_FPGA_SPI::worker_is_idle() const {
+    this->service_();
+    return this->jobs_.empty();
+}
+
+bool MatrixPanel_FPGA_SPI::status_spi_available() const {
+    return this->cfg_.status_gpio.sck >= 0 && this->cfg_.status_gpio.cs >= 0 &&
+           this->cfg_.status_gpio.miso >= 0;
+}
+
+bool MatrixPanel_FPGA_SPI::consume_fpga_reset() {
+    const bool pending = this->reset_pending_;
+    this->reset_pending_ = false;
+    return pending;
+}
+
+void MatrixPanel_FPGA_SPI::resync_after_fpga_reset(uint8_t brightness) {
+    this->brightness_ = brightness;
+    this->clearScreen();
+}
+
+void MatrixPanel_FPGA_SPI::clearScreen() {
+    this->submit_({Job::CLEAR, 0, 0, 0, 0, 0, 0, 0, nullptr, 0, 0}, 1, 0);
+}
+
+void MatrixPanel_FPGA_SPI::fillScreenRGB888(uint8_t r, uint8_t g, uint8_t b) {
+    const int16_t w = static_cast<int16_t>(this->sim_width());
+    const int16_t h = static_cast<int16_t>(this->sim_height());
+    this->submit_({Job::FILL, 0, 0, w, h, r, g, b, nullptr, 0, 0}, 4, 0);
+}
+
+void MatrixPanel_FPGA_SPI::fillRect(int16_t x, int16_t y, int16_t w,
+                                    int16_t h, uint8_t r, uint8_t g,
+                                    uint8_t b) {
+    this->submit_({Job::FILL, x, y, w, h, r, g, b, nullptr, 0, 0}, kFillBytes,
+                  static_cast<size_t>(std::max(0, w * h)));
+}
+
+void MatrixPanel_FPGA_SPI::swapFrame() {
+    this->submit_({Job::SWAP, 0, 0, 0, 0, 0, 0, 0, nullptr, 0, 0}, 1, 0);
+}
+
+void MatrixPanel_FPGA_SPI::copyFrame() {
+    this->submit_({Job::COPY, 0, 0, 0, 0, 0, 0, 0, nullptr, 0, 0}, 1, 0);
+}
+
+void MatrixPanel_FPGA_SPI::drawRectRGB888_prealloc(int16_t x, int16_t y,
+                                                   int16_t w, int16_t h,
+                                                   uint8_t *data, size_t len) {
+    this->submit_({Job::RECT, x, y, w, h, 0, 0, 0, data, len, 0},
+                  kRectHeaderBytes + len,
+                  static_cast<size_t>(std::max(0, w * h)));
+}
+
+void MatrixPanel_FPGA_SPI::submit_(Job job, size_t wire_bytes, size_t pixels) {
+    const FpgaSimModel &model = sim_model();
+    const uint64_t bits_ns =
+        static_cast<uint64_t>(wire_bytes) * 8 * 1000000000ull /
+        static_cast<uint32_t>(this->cfg_.spispeed);
+    const uint64_t duration_us =
+        model.command_latency_us + model.busy_us +
+        (bits_ns + static_cast<uint64_t>(pixels) * model.busy_ns_per_pixel +
+         999) / 1000;
+    this->stats_.wire_bytes += wire_bytes;
+    this->stats_.link_us += duration_us;
+    if (!this->worker_enabled_) {
+        // The caller's task drives the transfer itself.
+        host::advance_us(duration_us);
+        this->service_();
+        job.done_us = host::now_us();
+        this->apply_(job);
+        return;
+    }
+    this->service_();
+    const uint64_t start = std::max(host::now_us(), this->busy_until_us_);
+    job.done_us = start + duration_us;
+    this->busy_until_us_ = job.done_us;
+    this->jobs_.push_back(job);
+}
+
+void MatrixPanel_FPGA_SPI::service_() const {
+    const uint64_t now = host::now_us();
+    while (!this->jobs_.empty() && this->jobs_.front().done_us <= now) {
+        const Job job = this->jobs_.front();
+        this->jobs_.pop_front();
+        this->apply_(job);
+    }
+}
+
+void MatrixPanel_FPGA_SPI::fill_(int x, int y, int w, int h, uint8_t r,
+                                 uint8_t g, uint8_t b) const {
+    if (x < 0 || y < 0 || w < 0 || h < 0 || x + w > this->sim_width() ||
+        y + h > this->sim_height()) {
+        this->stats_.out_of_bounds++;
+        return;
+    }
+    for (int row = y; row < y + h; ++row) {
+        uint8_t *px = this->back_.data() +
+                      (static_cast<size_t>(row) * this->sim_width() + x) * 3;
+        for (int col = 0; col < w; ++col, px += 3) {
+            px[0] = r;
+            px[1] = g;
+            px[2] = b;
+        }
+    }
+}
+
+void MatrixPanel_FPGA_SPI::apply_(const Job &job) const {
+    const FpgaSimModel &model = sim_model();
+    switch (job.kind) {
+    case Job::CLEAR:
+        std::fill(this->back_.begin(), this->back_.end(), 0);
+        this->stats_.controls++;
+        break;
+    case Job::FILL:
+        this->fill_(job.x, job.y, job.w, job.h, job.r, job.g, job.b);
+        this->stats_.fills++;
+        break;
+    case Job::SWAP:
+        std::swap(this->back_, this->front_);
+        this->stats_.swaps++;
+        this->swap_log_.push_back(job.done_us);
+        if (model.on_swap)
+            model.on_swap(*this);
+        break;
+    case Job::COPY:
+        this->back_ = this->front_;
+        this->stats_.controls++;
+        break;
+    case Job::RECT: {
+        // The payload is read only now, as the transfer completes.
+        this->received_.assign(job.data, job.data + job.len);
+        this->rect_count_++;
+        const bool over_speed =
+            static_cast<uint32_t>(this->cfg_.spispeed) > model.max_clean_hz;
+        if (!this->received_.empty() &&
+            (over_speed || (model.corrupt_every != 0 &&
+                            this->rect_count_ % model.corrupt_every == 0))) {
+            this->received_[this->rect_count_ % this->received_.size()] ^= 0x10;
+            this->stats_.corrupted++;
+        }
+        for (uint8_t byte : this->received_)
+            this->payload_sum_ += byte;
+        this->rx_log_.emplace_back(
+            job.done_us, static_cast<uint32_t>(
+                             over_speed ? job.len / 2 : job.len));
+        this->stats_.rects++;
+        this->stats_.payload_bytes += job.len;
+        if (job.x < 0 || job.y < 0 || job.w <= 0 || job.h <= 0 ||
+            job.x + job.w > this->sim_width() ||
+            job.y + job.h > this->sim_height() ||
+            static_cast<size_t>(job.w) * job.h * 3 != job.len) {
+            this->stats_.out_of_bounds++;
+            break;
+        }
+        const size_t row_bytes = static_cast<size_t>(job.w) * 3;
+        for (int row = 0; row < job.h; ++row) {
+            std::memcpy(this->back_.data() +
+                            ((static_cast<size_t>(job.y) + row) *
+                                 this->sim_width() +
+                             job.x) *
+                                3,
+                        this->received_.data() + row * row_bytes, row_bytes);
+        }
+        break;
+    }
+    }
+}
+
+void MatrixPanel_FPGA_SPI::sim_reset() {
+    this->jobs_.clear();
+    this->busy_until_us_ = 0;
+    std::fill(this->back_.begin(), this->back_.end(), 0);
+    std::fill(this->front_.begin(), this->front_.end(), 0);
+    this->payload_sum_ = 0;
+    this->reset_epoch_++;
+    this->reset_pending_ = true;
+}
+
+bool MatrixPanel_FPGA_SPI::status_ready_() {
+    this->status_reads_++;
+    if (!this->status_spi_available()) {
+        this->status_error_ = NOT_AVAILABLE;
+        return false;
+    }
+    if (!this->ready_) {
+        this->status_error_ = NOT_READY;
+        return false;
+    }
+    this->service_();
+    this->status_error_ = NONE;
+    return true;
+}
+
+bool MatrixPanel_FPGA_SPI::readFlags(FpgaStatusFlags &flags) {
+    if (!this->status_ready_())
+        return false;
+    flags.fpga_ready = this->ready_;
+    flags.ctrl_busy = !this->jobs_.empty();
+    flags.ctrl_ready_for_data = this->jobs_.empty();
+    return true;
+}
+
+bool MatrixPanel_FPGA_SPI::readStatus(uint8_t addr, uint64_t &value) {
+    if (!this->status_ready_())
+        return false;
+    const uint64_t now = host::now_us();
+    while (!this->rx_log_.empty() &&
+           now - this->rx_log_.front().first > kRateWindowUs)
+        this->rx_log_.pop_front();
+    while (!this->swap_log_.empty() &&
+           now - this->swap_log_.front() > kRateWindowUs)
+        this->swap_log_.pop_front();
+    const FpgaSimModel &model = sim_model();
+    if (addr == model.integrity_addr) {
+        value = this->payload_sum_;
+        return true;
+    }
+    switch (addr) {
+    case STATUS_ADDR_RX_KBPS: {
+        // Bytes per millisecond is kB/s.
+        uint64_t bytes = 0;
+        for (const auto &entry : this->rx_log_)
+            bytes += entry.second;
+        value = bytes / (kRateWindowUs / 1000);
+        return true;
+    }
+    case STATUS_ADDR_HUB75_FPS:
+        value = model.hub75_fps;
+        return true;
+    case STATUS_ADDR_FB_FPS:
+        value = this->swap_log_.size();
+        return true;
+    case STATUS_ADDR_UPTIME:
+        value = now / 1000000;
+        return true;
+    default:
+        value = 0;
+        return true;
+    }
+}
+
+bool MatrixPanel_FPGA_SPI::readVersion(FpgaVersion &version) {
+    if (!this->status_ready_())
+        return false;
+    version = {2, 11, 1};
+    return true;
+}
+
+void MatrixPanel_FPGA_SPI::last_status_frame(uint8_t *frame) const {
+    std::memset(frame, 0, STATUS_FRAME_LEN);
+}
+
+const char *MatrixPanel_FPGA_SPI::status_error_str(StatusError error) {
+    switch (error) {
+    case NONE:
+        return "none";
+    case NOT_AVAILABLE:
+        return "status SPI not available";
+    case NOT_READY:
+        return "FPGA not ready";
+    }
+    return "unknown";
+}
+
+void MatrixPanel_FPGA_SPI::formatVersion(const FpgaVersion &version, char *out,
+                                         size_t len) {
+    std::snprintf(out, len, "%u.%u.%u", version.major, version.minor,
+                  version.patch);
+}
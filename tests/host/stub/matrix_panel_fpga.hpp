@@ -0,0 +1,223 @@
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+// Host stand-in for the ESP32-FPGA-MatrixPanel driver. It keeps the
+// library's interface and simulates the FPGA behind it: a back and a front
+// framebuffer, the status registers, and a link whose timing follows the
+// configured clock, the worker's per-command latency and the BUSY hold after
+// each command. Rects are read from the caller's buffer when they complete,
+// as the worker's DMA would, so reusing a buffer too early shows up as
+// corrupt pixels.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <utility>
+#include <vector>
+
+struct FPGA_SPI_CFG {
+    enum clk_speed {
+        HZ_8M = 8000000,
+        HZ_10M = 10000000,
+        HZ_15M = 15000000,
+        HZ_16M = 16000000,
+        HZ_20M = 20000000,
+        HZ_26M = 26000000,
+        HZ_40M = 40000000,
+        HZ_80M = 80000000,
+    };
+    struct {
+        int8_t ce = -1, clk = -1, mosi = -1, fpga_resetstatus = -1,
+               fpga_busy = -1;
+    } gpio;
+    struct {
+        int8_t sck = -1, cs = -1, miso = -1;
+    } status_gpio;
+    uint16_t mx_width = 64;
+    uint16_t mx_height = 32;
+    uint16_t chain_length = 1;
+    clk_speed spispeed = HZ_20M;
+    int min_refresh_rate = 60;
+};
+
+class MatrixPanel_FPGA_SPI;
+
+/// Timing and fault model of the simulated FPGA, shared by every driver.
+struct FpgaSimModel {
+    /// @brief fixed time per command before its first bit goes out: the
+    /// worker hand-off, DMA set-up and chip select
+    uint32_t command_latency_us = 20;
+    /// @brief BUSY hold after each command while the FPGA stores it
+    uint32_t busy_us = 2;
+    /// @brief further BUSY hold per pixel a command writes
+    uint32_t busy_ns_per_pixel = 0;
+    /// @brief fastest clock the link carries cleanly; above it every rect
+    /// arrives damaged and half of its bytes are lost
+    uint32_t max_clean_hz = 80000000;
+    /// @brief damages one byte of every nth rect payload; 0 = never
+    uint32_t corrupt_every = 0;
+    /// @brief status register holding the running sum of payload bytes
+    uint8_t integrity_addr = 8;
+    /// @brief HUB75 refresh rate the status registers report
+    uint32_t hub75_fps = 120;
+    /// @brief called with the driver after every swap reaches the FPGA
+    std::function<void(const MatrixPanel_FPGA_SPI &)> on_swap;
+};
+
+class MatrixPanel_FPGA_SPI {
+  public:
+    static constexpr uint8_t STATUS_ADDR_FLAGS = 0;
+    static constexpr uint8_t STATUS_ADDR_RX_KBPS = 1;
+    static constexpr uint8_t STATUS_ADDR_HUB75_FPS = 2;
+    static constexpr uint8_t STATUS_ADDR_FB_FPS = 3;
+    static constexpr uint8_t STATUS_ADDR_UPTIME = 4;
+    static constexpr uint8_t STATUS_ADDR_VERSION = 5;
+    static constexpr size_t STATUS_FRAME_LEN = 10;
+    static constexpr size_t VERSION_STR_MAX = 48;
+
+    /// @brief bytes the stand-in puts on the wire ahead of a rect payload
+    /// (opcode and four 16-bit coordinates), and for a fill (plus colour)
+    static constexpr size_t kRectHeaderBytes = 9;
+    static constexpr size_t kFillBytes = kRectHeaderBytes + 3;
+
+    struct FpgaStatusFlags {
+        bool fpga_ready = false;
+        bool ctrl_busy = false;
+        bool ctrl_ready_for_data = false;
+    };
+    struct FpgaVersion {
+        uint8_t major = 0;
+        uint8_t minor = 0;
+        uint8_t patch = 0;
+    };
+    enum StatusError : uint8_t { NONE, NOT_AVAILABLE, NOT_READY };
+
+    /// @brief what the simulated FPGA has received since construction
+    struct SimStats {
+        uint32_t rects = 0;
+        uint32_t fills = 0;
+        uint32_t swaps = 0;
+        uint32_t controls = 0;
+        uint64_t payload_bytes = 0;
+        uint64_t wire_bytes = 0;
+        /// @brief rect payloads damaged on the way in
+        uint32_t corrupted = 0;
+        /// @brief commands that reached outside the chain
+        uint32_t out_of_bounds = 0;
+        /// @brief time the link was occupied, in microseconds
+        uint64_t link_us = 0;
+    };
+
+    explicit MatrixPanel_FPGA_SPI(const FPGA_SPI_CFG &cfg);
+    /// @brief aborts if the worker is still enabled or holds transfers,
+    /// which the library's destructor cannot tear down safely
+    ~MatrixPanel_FPGA_SPI();
+
+    bool begin();
+    void set_worker_core(int core) {}
+    void enable_worker(bool enable) { this->worker_enabled_ = enable; }
+    bool is_worker_enabled() const { return this->worker_enabled_; }
+    bool worker_is_idle() const;
+
+    bool status_spi_available() const;
+    bool fpga_ready() const { return this->ready_; }
+    void fulfillWatchdog() { this->watchdog_feeds_++; }
+    bool consume_fpga_reset();
+    void resync_after_fpga_reset(uint8_t brightness);
+    uint32_t get_reset_epoch() const { return this->reset_epoch_; }
+
+    void clearScreen();
+    void fillScreenRGB888(uint8_t r, uint8_t g, uint8_t b);
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t r,
+                  uint8_t g, uint8_t b);
+    void setBrightness8(uint8_t brightness) { this->brightness_ = brightness; }
+    void swapFrame();
+    void copyFrame();
+    void run_test_graphic() { this->test_graphics_++; }
+    void drawRectRGB888_prealloc(int16_t x, int16_t y, int16_t w, int16_t h,
+                                 uint8_t *data, size_t len);
+
+    FPGA_SPI_CFG getCfg() const { return this->cfg_; }
+    bool readFlags(FpgaStatusFlags &flags);
+    bool readStatus(uint8_t addr, uint64_t &value);
+    bool readVersion(FpgaVersion &version);
+    void last_status_frame(uint8_t *frame) const;
+    StatusError last_status_error() const { return this->status_error_; }
+    static const char *status_error_str(StatusError error);
+    static void formatVersion(const FpgaVersion &version, char *out,
+                              size_t len);
+
+    /// @brief the model every driver instance runs on
+    static FpgaSimModel &sim_model();
+    const SimStats &sim_stats() const {
+        this->service_();
+        return this->stats_;
+    }
+    /// @brief chain-space RGB888 framebuffers: the one being drawn, and the
+    /// one on the panel
+    const std::vector<uint8_t> &sim_back() const {
+        this->service_();
+        return this->back_;
+    }
+    const std::vector<uint8_t> &sim_front() const {
+        this->service_();
+        return this->front_;
+    }
+    int sim_width() const { return this->cfg_.mx_width * this->cfg_.chain_length; }
+    int sim_height() const { return this->cfg_.mx_height; }
+    uint8_t sim_brightness() const { return this->brightness_; }
+    uint32_t sim_watchdog_feeds() const { return this->watchdog_feeds_; }
+    /// @brief the FPGA reloads its gateware: both framebuffers and the queued
+    /// commands are lost and the reset flag is raised
+    void sim_reset();
+    /// @brief holds the FPGA in reset/config (not ready) or releases it
+    void sim_set_ready(bool ready) { this->ready_ = ready; }
+    /// @brief status-SPI transactions attempted since construction
+    uint32_t sim_status_reads() const { return this->status_reads_; }
+
+  protected:
+    struct Job {
+        enum Kind : uint8_t { RECT, FILL, CLEAR, SWAP, COPY } kind;
+        int16_t x, y, w, h;
+        uint8_t r, g, b;
+        const uint8_t *data;
+        size_t len;
+        uint64_t done_us;
+    };
+
+    /// @brief queues a command behind the ones in flight, or runs it at once
+    /// without the worker
+    void submit_(Job job, size_t wire_bytes, size_t pixels);
+    /// @brief applies every queued command whose transfer has completed
+    void service_() const;
+    void apply_(const Job &job) const;
+    void fill_(int x, int y, int w, int h, uint8_t r, uint8_t g,
+               uint8_t b) const;
+    bool status_ready_();
+
+    FPGA_SPI_CFG cfg_;
+    bool worker_enabled_ = false;
+    bool ready_ = true;
+    bool begun_ = false;
+    uint32_t status_reads_ = 0;
+    uint8_t brightness_ = 0;
+    uint32_t watchdog_feeds_ = 0;
+    uint32_t test_graphics_ = 0;
+    uint32_t reset_epoch_ = 0;
+    bool reset_pending_ = false;
+    StatusError status_error_ = NONE;
+
+    mutable std::deque<Job> jobs_;
+    mutable uint64_t busy_until_us_ = 0;
+    mutable std::vector<uint8_t> back_;
+    mutable std::vector<uint8_t> front_;
+    mutable std::vector<uint8_t> received_;
+    mutable uint32_t payload_sum_ = 0;
+    mutable uint32_t rect_count_ = 0;
+    mutable SimStats stats_;
+    /// @brief (completion time, bytes) of recent payloads, for RX_KBPS
+    mutable std::deque<std::pair<uint64_t, uint32_t>> rx_log_;
+    /// @brief completion times of recent swaps, for FB_FPS
+    mutable std::deque<uint64_t> swap_log_;
+};
@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+// Stall with a tiled framebuffer: the worker sends rects straight from the
+// framebuffer, so after a pass gives up on a stalled worker the writer must
+// not draw again until the rects still queued have gone out. Once they
+// have, the next frames complete normally.
+#include <cstdio>
+
+#include "host_display.h"
+
+using namespace host;
+
+int main() {
+    FpgaSimModel &model = MatrixPanel_FPGA_SPI::sim_model();
+    HostDisplay display(64, 32, 2, FPGA_SPI_CFG::HZ_26M);
+    display.set_tiled_framebuffer(true);
+    display.set_worker_idle_timeout_ms(5);
+    uint32_t renders = 0;
+    display.set_writer([&](esphome::display::Display &it) {
+        renders++;
+        it.filled_rectangle(0, 0, display.width(), display.height(),
+                            Color(renders * 40, 90, 200 - renders * 10));
+    });
+    display.setup();
+    HOST_CHECK(!display.is_failed());
+    display.frame();
+    HOST_CHECK(count_mismatches(display) == 0);
+
+    // Every command now holds the link for 20 ms, far past the 5 ms the
+    // flush waits, so the pass is abandoned with rects still queued.
+    model.command_latency_us = 20000;
+    host::advance_us(16000);
+    display.update();
+    HOST_CHECK(display.flush_idle());
+    HOST_CHECK(!display.fpga().worker_is_idle());
+    const uint32_t stalled_at = renders;
+    // The link recovers, but the rects already queued still take 20 ms each.
+    model.command_latency_us = 20;
+
+    uint32_t held = 0;
+    while (!display.fpga().worker_is_idle()) {
+        display.update();
+        HOST_CHECK(renders == stalled_at);
+        held++;
+        host::advance_us(5000);
+    }
+    HOST_CHECK(held > 0);
+
+    for (int i = 0; i < 3; ++i) {
+        host::advance_us(16000);
+        display.frame();
+    }
+    HOST_CHECK(renders > stalled_at);
+    HOST_CHECK(count_mismatches(display) == 0);
+    std::printf("tiled stall: writer held for %u updates\n", held);
+    return 0;
+}
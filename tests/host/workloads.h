@@ -0,0 +1,96 @@
+// SPDX-FileCopyrightText: 2026 Aaron White <w531t4@gmail.com>
+// SPDX-License-Identifier: GPL-3.0-only
+// The flush workloads of tests/bench.yaml, for the host benchmarks. Text is
+// drawn with a fixed pseudo-glyph pattern instead of a font.
+#pragma once
+
+#include <cstdint>
+
+#include "host_display.h"
+
+namespace host {
+
+enum class Workload : uint8_t { FULL, SPARSE, MARQUEE, IDLE, ICONS, SCROLL };
+
+inline const char *workload_name(Workload workload) {
+    switch (workload) {
+    case Workload::FULL:
+        return "full redraw";
+    case Workload::SPARSE:
+        return "sparse pixels";
+    case Workload::MARQUEE:
+        return "marquee";
+    case Workload::IDLE:
+        return "idle";
+    case Workload::ICONS:
+        return "icon blits";
+    case Workload::SCROLL:
+        return "scroll_region";
+    }
+    return "?";
+}
+
+/// @brief a 6x10 cell of "text" at column x: on where the pattern says so
+inline void draw_glyph(HostDisplay &it, int x, int y, char c, Color color) {
+    for (int row = 0; row < 10; ++row) {
+        for (int col = 0; col < 5; ++col) {
+            if ((c * 31 + col * 7 + row * 3) % 5 < 2)
+                it.draw_pixel_at(x + col, y + row, color);
+        }
+    }
+}
+
+inline void draw_text(HostDisplay &it, int x, int y, const char *text) {
+    for (; *text != '\0'; ++text, x += 6)
+        draw_glyph(it, x, y, *text, Color::WHITE);
+}
+
+/// @brief draws one frame of a workload, as the bench.yaml lambda does
+inline void run_workload(HostDisplay &it, Workload workload, uint32_t frame) {
+    static const char *const kTicker = "Scrolling ticker text";
+    const int w = it.get_width();
+    const int h = it.get_height();
+    switch (workload) {
+    case Workload::FULL:
+        for (int y = 0; y < h; y++)
+            for (int x = 0; x < w; x++)
+                it.draw_pixel_at(x, y,
+                                 Color((x + frame) & 0xFF, (y + frame) & 0xFF,
+                                       frame & 0xFF));
+        break;
+    case Workload::SPARSE: {
+        const uint32_t last = frame - 1;
+        it.draw_pixel_at(last % w, (last / w) % h, Color::BLACK);
+        it.draw_pixel_at(frame % w, (frame / w) % h, Color::WHITE);
+        break;
+    }
+    case Workload::MARQUEE:
+        it.filled_rectangle(0, 0, w, 14, Color::BLACK);
+        draw_text(it, w - static_cast<int>(frame % (2 * w)), 2, kTicker);
+        break;
+    case Workload::ICONS: {
+        static uint8_t icon[16 * 16 * 3];
+        for (int i = 0; i < 16 * 16; i++) {
+            icon[i * 3 + 0] = (i * 7) & 0xFF;
+            icon[i * 3 + 1] = (i * 13) & 0xFF;
+            icon[i * 3 + 2] = (i * 29) & 0xFF;
+        }
+        for (int x = 0; x + 16 <= w; x += 16)
+            it.draw_pixels_at(x, (frame / 8) % (h - 15), 16, 16, icon,
+                              esphome::display::COLOR_ORDER_RGB,
+                              esphome::display::COLOR_BITNESS_888, true, 0, 0,
+                              0);
+        break;
+    }
+    case Workload::SCROLL:
+        it.scroll_region(0, 0, w, 14, -1, 0, Color::BLACK);
+        it.start_clipping(w - 1, 0, w, 14);
+        draw_text(it, w - static_cast<int>(frame % (2 * w)), 2, kTicker);
+        it.end_clipping();
+        break;
+    case Workload::IDLE:
+        break;
+    }
+}
+
+} // namespace host